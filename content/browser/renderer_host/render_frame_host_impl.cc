@@ -3917,6 +3917,10 @@ void RenderFrameHostImpl::SetDOMConstraintHTML(const std::string& dom_constraint
   GetAssociatedLocalFrame()->SetDOMConstraintHTML(dom_constraint_html);
 }
 
+void RenderFrameHostImpl::SetDOMConstraintData(base::ReadOnlySharedMemoryRegion dom_constraint_data) {
+  GetAssociatedLocalFrame()->SetDOMConstraintData(std::move(dom_constraint_data));
+}
+
 void RenderFrameHostImpl::SetDOMConstraintMode(const std::string& dom_constraint_mode) {
   GetAssociatedLocalFrame()->SetDOMConstraintMode(dom_constraint_mode);
 }
@@ -3925,6 +3929,14 @@ void RenderFrameHostImpl::OutputDOMConstraintHTML() {
   GetAssociatedLocalFrame()->OutputDOMConstraintHTML();
 }
 
+void RenderFrameHostImpl::GetDOMConstraintData(bool delta_only, base::OnceCallback<void(base::ReadOnlySharedMemoryRegion)> callback) {
+  GetAssociatedLocalFrame()->GetDOMConstraintData(delta_only, std::move(callback));
+}
+
+void RenderFrameHostImpl::DiscardDOMConstraintRecording() {
+  GetAssociatedLocalFrame()->DiscardDOMConstraintRecording();
+}
+
 StoragePartition* RenderFrameHostImpl::GetStoragePartition() {
   return BrowserContext::GetStoragePartition(GetBrowserContext(),
                                              GetSiteInstance());
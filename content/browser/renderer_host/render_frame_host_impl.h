@@ -415,8 +415,11 @@ class CONTENT_EXPORT RenderFrameHostImpl
                           blink::mojom::HeavyAdReason reason) override;
   void AsValueInto(base::trace_event::TracedValue* traced_value) override;
   void SetDOMConstraintHTML(const std::string& dom_constraint_html) override;
+  void SetDOMConstraintData(base::ReadOnlySharedMemoryRegion dom_constraint_data) override;
   void SetDOMConstraintMode(const std::string& dom_constraint_mode) override;
   void OutputDOMConstraintHTML() override;
+  void GetDOMConstraintData(bool delta_only, base::OnceCallback<void(base::ReadOnlySharedMemoryRegion)> callback) override;
+  void DiscardDOMConstraintRecording() override;
   
   // Determines if a clipboard paste using |data| of type |data_type| is allowed
   // in this renderer frame.  The implementation delegates to
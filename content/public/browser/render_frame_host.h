@@ -11,6 +11,7 @@
 #include "base/callback_forward.h"
 #include "base/containers/flat_set.h"
 #include "base/feature_list.h"
+#include "base/memory/read_only_shared_memory_region.h"
 #include "base/optional.h"
 #include "build/build_config.h"
 #include "cc/input/browser_controls_state.h"
@@ -708,11 +709,20 @@ class CONTENT_EXPORT RenderFrameHost : public IPC::Listener,
   virtual void AsValueInto(base::trace_event::TracedValue* traced_value) = 0;
 
   virtual void SetDOMConstraintHTML(const std::string& dom_constraint_html) = 0;
+
+  virtual void SetDOMConstraintData(base::ReadOnlySharedMemoryRegion dom_constraint_data) = 0;
   
   virtual void SetDOMConstraintMode(const std::string& dom_constraint_mode) = 0;
 
   virtual void OutputDOMConstraintHTML() = 0;
 
+  // Runs |callback| with the current constraint in binary form, or with an
+  // invalid region if the frame has none. With |delta_only|, only what record
+  // mode added on top of a shared constraint is returned.
+  virtual void GetDOMConstraintData(bool delta_only, base::OnceCallback<void(base::ReadOnlySharedMemoryRegion)> callback) = 0;
+
+  virtual void DiscardDOMConstraintRecording() = 0;
+
  private:
   // This interface should only be implemented inside content.
   friend class RenderFrameHostImpl;
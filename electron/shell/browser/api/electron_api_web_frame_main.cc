@@ -11,6 +11,7 @@
 
 #include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/memory/read_only_shared_memory_region.h"
 #include "content/browser/renderer_host/frame_tree_node.h"  // nogncheck
 #include "content/public/browser/render_frame_host.h"
 #include "electron/shell/common/api/api.mojom.h"
@@ -18,6 +19,7 @@
 #include "services/service_manager/public/cpp/interface_provider.h"
 #include "shell/browser/api/message_port.h"
 #include "shell/browser/browser.h"
+#include "shell/browser/dom_constraint_registry.h"
 #include "shell/browser/javascript_environment.h"
 #include "shell/common/gin_converters/blink_converter.h"
 #include "shell/common/gin_converters/frame_converter.h"
@@ -46,6 +48,28 @@ WebFrameMain* FromRenderFrameHost(content::RenderFrameHost* rfh) {
   return web_frame;
 }
 
+// Copies a Buffer into a new read-only shared memory region. Throws and returns
+// an invalid region on failure.
+base::ReadOnlySharedMemoryRegion DOMConstraintDataFromBuffer(
+    v8::Isolate* isolate,
+    v8::Local<v8::Value> buffer) {
+  if (!node::Buffer::HasInstance(buffer)) {
+    gin_helper::ErrorThrower(isolate).ThrowTypeError(
+        "DOM constraint data must be a Buffer");
+    return base::ReadOnlySharedMemoryRegion();
+  }
+  size_t size = node::Buffer::Length(buffer);
+  base::MappedReadOnlyRegion region =
+      base::ReadOnlySharedMemoryRegion::Create(size);
+  if (!region.IsValid()) {
+    gin_helper::ErrorThrower(isolate).ThrowError(
+        "Failed to allocate shared memory for the DOM constraint");
+    return base::ReadOnlySharedMemoryRegion();
+  }
+  memcpy(region.mapping.memory(), node::Buffer::Data(buffer), size);
+  return std::move(region.region);
+}
+
 gin::WrapperInfo WebFrameMain::kWrapperInfo = {gin::kEmbedderNativeGin};
 
 WebFrameMain::WebFrameMain(content::RenderFrameHost* rfh) : render_frame_(rfh) {
@@ -197,6 +221,17 @@ void WebFrameMain::SetDOMConstraintHTML(const std::string& dom_constraint_html)
   render_frame_->SetDOMConstraintHTML(dom_constraint_html);
 }
 
+void WebFrameMain::SetDOMConstraintData(
+    v8::Isolate* isolate,
+    v8::Local<v8::Value> dom_constraint_data) {
+  base::ReadOnlySharedMemoryRegion region =
+      DOMConstraintDataFromBuffer(isolate, dom_constraint_data);
+  if (!region.IsValid() || !CheckRenderFrame()) {
+    return;
+  }
+  render_frame_->SetDOMConstraintData(std::move(region));
+}
+
 void WebFrameMain::SetDOMConstraintMode(const std::string& dom_constraint_mode) {
   if (!CheckRenderFrame()) {
     return;
@@ -211,6 +246,50 @@ void WebFrameMain::OutputDOMConstraintHTML() {
   render_frame_->OutputDOMConstraintHTML();
 }
 
+void WebFrameMain::DiscardDOMConstraintRecording() {
+  if (!CheckRenderFrame()) {
+    return;
+  }
+  render_frame_->DiscardDOMConstraintRecording();
+}
+
+v8::Local<v8::Promise> WebFrameMain::GetDOMConstraintData(
+    gin::Arguments* args) {
+  bool delta_only = false;
+  args->GetNext(&delta_only);
+
+  gin_helper::Promise<v8::Local<v8::Value>> promise(args->isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  if (render_frame_disposed_) {
+    promise.RejectWithErrorMessage(
+        "Render frame was disposed before WebFrameMain could be accessed");
+    return handle;
+  }
+
+  render_frame_->GetDOMConstraintData(delta_only, base::BindOnce(
+      [](gin_helper::Promise<v8::Local<v8::Value>> promise,
+         base::ReadOnlySharedMemoryRegion region) {
+        base::ReadOnlySharedMemoryMapping mapping = region.Map();
+        if (!mapping.IsValid()) {
+          promise.RejectWithErrorMessage("The frame has no DOM constraint");
+          return;
+        }
+        v8::Isolate* isolate = promise.isolate();
+        v8::HandleScope handle_scope(isolate);
+        v8::Context::Scope context_scope(promise.GetContext());
+        promise.Resolve(
+            node::Buffer::Copy(isolate,
+                               static_cast<const char*>(mapping.memory()),
+                               mapping.size())
+                .ToLocalChecked()
+                .As<v8::Value>());
+      },
+      std::move(promise)));
+
+  return handle;
+}
+
 int WebFrameMain::FrameTreeNodeID() const {
   if (!CheckRenderFrame())
     return -1;
@@ -348,7 +427,11 @@ v8::Local<v8::ObjectTemplate> WebFrameMain::FillObjectTemplate(
       .SetMethod("_postMessage", &WebFrameMain::PostMessage)
       .SetMethod("setDOMConstraintHTML", &WebFrameMain::SetDOMConstraintHTML)
       .SetMethod("setDOMConstraintMode", &WebFrameMain::SetDOMConstraintMode)
+      .SetMethod("setDOMConstraintData", &WebFrameMain::SetDOMConstraintData)
       .SetMethod("outputDOMConstraintHTML", &WebFrameMain::OutputDOMConstraintHTML)
+      .SetMethod("getDOMConstraintData", &WebFrameMain::GetDOMConstraintData)
+      .SetMethod("discardDOMConstraintRecording",
+                 &WebFrameMain::DiscardDOMConstraintRecording)
       .SetProperty("frameTreeNodeId", &WebFrameMain::FrameTreeNodeID)
       .SetProperty("name", &WebFrameMain::Name)
       .SetProperty("osProcessId", &WebFrameMain::OSProcessID)
@@ -387,6 +470,23 @@ v8::Local<v8::Value> FromID(gin_helper::ErrorThrower thrower,
       .ToV8();
 }
 
+void RegisterDOMConstraint(gin_helper::ErrorThrower thrower,
+                           const std::string& url_pattern,
+                           v8::Local<v8::Value> dom_constraint_data) {
+  base::ReadOnlySharedMemoryRegion region =
+      electron::api::DOMConstraintDataFromBuffer(thrower.isolate(),
+                                                 dom_constraint_data);
+  if (!region.IsValid()) {
+    return;
+  }
+  electron::DOMConstraintRegistry::GetInstance()->Register(url_pattern,
+                                                           std::move(region));
+}
+
+void UnregisterDOMConstraint(const std::string& url_pattern) {
+  electron::DOMConstraintRegistry::GetInstance()->Unregister(url_pattern);
+}
+
 void Initialize(v8::Local<v8::Object> exports,
                 v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context,
@@ -395,6 +495,8 @@ void Initialize(v8::Local<v8::Object> exports,
   gin_helper::Dictionary dict(isolate, exports);
   dict.Set("WebFrameMain", WebFrameMain::GetConstructor(context));
   dict.SetMethod("fromId", &FromID);
+  dict.SetMethod("registerDOMConstraint", &RegisterDOMConstraint);
+  dict.SetMethod("unregisterDOMConstraint", &UnregisterDOMConstraint);
 }
 
 }  // namespace
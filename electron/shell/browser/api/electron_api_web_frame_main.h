@@ -89,8 +89,14 @@ class WebFrameMain : public gin::Wrappable<WebFrameMain>,
                    v8::Local<v8::Value> message_value,
                    base::Optional<v8::Local<v8::Value>> transfer);
   void SetDOMConstraintHTML(const std::string& dom_constraint_html);
+  void SetDOMConstraintData(v8::Isolate* isolate,
+                            v8::Local<v8::Value> dom_constraint_data);
   void SetDOMConstraintMode(const std::string& dom_constraint_mode);
   void OutputDOMConstraintHTML();
+  // With a true argument, only what was recorded on top of a registered
+  // constraint is returned.
+  v8::Local<v8::Promise> GetDOMConstraintData(gin::Arguments* args);
+  void DiscardDOMConstraintRecording();
 
   int FrameTreeNodeID() const;
   std::string Name() const;
@@ -0,0 +1,39 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/dom_constraint_navigation_observer.h"
+
+#include <utility>
+
+#include "base/memory/read_only_shared_memory_region.h"
+#include "content/public/browser/navigation_handle.h"
+#include "content/public/browser/render_frame_host.h"
+#include "shell/browser/dom_constraint_registry.h"
+
+namespace electron {
+
+DOMConstraintNavigationObserver::DOMConstraintNavigationObserver(
+    content::WebContents* web_contents)
+    : content::WebContentsObserver(web_contents) {}
+
+DOMConstraintNavigationObserver::~DOMConstraintNavigationObserver() = default;
+
+void DOMConstraintNavigationObserver::ReadyToCommitNavigation(
+    content::NavigationHandle* navigation_handle) {
+  // Same-document navigations keep the document, and with it the constraint
+  // it was committed with.
+  if (navigation_handle->IsSameDocument())
+    return;
+
+  base::ReadOnlySharedMemoryRegion region =
+      DOMConstraintRegistry::GetInstance()->Find(navigation_handle->GetURL());
+  if (!region.IsValid())
+    return;
+  navigation_handle->GetRenderFrameHost()->SetDOMConstraintData(
+      std::move(region));
+}
+
+WEB_CONTENTS_USER_DATA_KEY_IMPL(DOMConstraintNavigationObserver)
+
+}  // namespace electron
@@ -0,0 +1,40 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_DOM_CONSTRAINT_NAVIGATION_OBSERVER_H_
+#define SHELL_BROWSER_DOM_CONSTRAINT_NAVIGATION_OBSERVER_H_
+
+#include "base/macros.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "content/public/browser/web_contents_user_data.h"
+
+namespace electron {
+
+// Hands every frame of a WebContents the constraint that the
+// DOMConstraintRegistry holds for the URL it is about to commit. The
+// constraint is sent ahead of the commit on the same frame channel, so it is
+// enforced from the first element the new document inserts.
+class DOMConstraintNavigationObserver
+    : public content::WebContentsObserver,
+      public content::WebContentsUserData<DOMConstraintNavigationObserver> {
+ public:
+  ~DOMConstraintNavigationObserver() override;
+
+  // content::WebContentsObserver:
+  void ReadyToCommitNavigation(
+      content::NavigationHandle* navigation_handle) override;
+
+ private:
+  friend class content::WebContentsUserData<DOMConstraintNavigationObserver>;
+
+  explicit DOMConstraintNavigationObserver(content::WebContents* web_contents);
+
+  WEB_CONTENTS_USER_DATA_KEY_DECL();
+
+  DISALLOW_COPY_AND_ASSIGN(DOMConstraintNavigationObserver);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_DOM_CONSTRAINT_NAVIGATION_OBSERVER_H_
@@ -0,0 +1,50 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/dom_constraint_registry.h"
+
+#include <utility>
+
+#include "base/strings/pattern.h"
+#include "url/gurl.h"
+
+namespace electron {
+
+// static
+DOMConstraintRegistry* DOMConstraintRegistry::GetInstance() {
+  static base::NoDestructor<DOMConstraintRegistry> instance;
+  return instance.get();
+}
+
+DOMConstraintRegistry::DOMConstraintRegistry() = default;
+
+DOMConstraintRegistry::~DOMConstraintRegistry() = default;
+
+void DOMConstraintRegistry::Register(
+    const std::string& url_pattern,
+    base::ReadOnlySharedMemoryRegion dom_constraint_data) {
+  constraints_[url_pattern] = std::move(dom_constraint_data);
+}
+
+void DOMConstraintRegistry::Unregister(const std::string& url_pattern) {
+  constraints_.erase(url_pattern);
+}
+
+base::ReadOnlySharedMemoryRegion DOMConstraintRegistry::Find(
+    const GURL& url) const {
+  const base::ReadOnlySharedMemoryRegion* best_match = nullptr;
+  size_t best_match_length = 0;
+  for (const auto& constraint : constraints_) {
+    if (constraint.first.length() >= best_match_length &&
+        base::MatchPattern(url.spec(), constraint.first)) {
+      best_match = &constraint.second;
+      best_match_length = constraint.first.length();
+    }
+  }
+  // Duplicates keep the region's GUID, which is what renderers share by.
+  return best_match ? best_match->Duplicate()
+                    : base::ReadOnlySharedMemoryRegion();
+}
+
+}  // namespace electron
@@ -0,0 +1,51 @@
+// Copyright (c) 2020 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_DOM_CONSTRAINT_REGISTRY_H_
+#define SHELL_BROWSER_DOM_CONSTRAINT_REGISTRY_H_
+
+#include <map>
+#include <string>
+
+#include "base/macros.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/no_destructor.h"
+
+class GURL;
+
+namespace electron {
+
+// Binary DOM constraints (see blink's dom_constraint_serialization.h), keyed
+// by the URL pattern they apply to. Each constraint is held once, as a
+// read-only shared memory region, and every matching frame is handed a
+// duplicate of that same region. A renderer that receives it for several
+// frames therefore loads it only once and shares the result between them.
+class DOMConstraintRegistry {
+ public:
+  static DOMConstraintRegistry* GetInstance();
+
+  // |url_pattern| is matched against the whole URL and may use the '*' and
+  // '?' wildcards. Registering a pattern again replaces its constraint.
+  void Register(const std::string& url_pattern,
+                base::ReadOnlySharedMemoryRegion dom_constraint_data);
+  void Unregister(const std::string& url_pattern);
+
+  // Returns a duplicate of the constraint with the longest pattern that
+  // matches |url|, or an invalid region if none does.
+  base::ReadOnlySharedMemoryRegion Find(const GURL& url) const;
+
+ private:
+  friend class base::NoDestructor<DOMConstraintRegistry>;
+
+  DOMConstraintRegistry();
+  ~DOMConstraintRegistry();
+
+  std::map<std::string, base::ReadOnlySharedMemoryRegion> constraints_;
+
+  DISALLOW_COPY_AND_ASSIGN(DOMConstraintRegistry);
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_DOM_CONSTRAINT_REGISTRY_H_
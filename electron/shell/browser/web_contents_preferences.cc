@@ -20,6 +20,7 @@
 #include "electron/buildflags/buildflags.h"
 #include "net/base/filename_util.h"
 #include "sandbox/policy/switches.h"
+#include "shell/browser/dom_constraint_navigation_observer.h"
 #include "shell/browser/native_window.h"
 #include "shell/browser/web_view_manager.h"
 #include "shell/common/gin_converters/value_converter.h"
@@ -114,6 +115,7 @@ WebContentsPreferences::WebContentsPreferences(
 
   gin::ConvertFromV8(isolate, copied.GetHandle(), &preference_);
   web_contents->SetUserData(UserDataKey(), base::WrapUnique(this));
+  DOMConstraintNavigationObserver::CreateForWebContents(web_contents);
 
   instances_.push_back(this);
 
@@ -95,7 +95,10 @@ declare namespace Electron {
     _send(internal: boolean, channel: string, args: any): void;
     _sendInternal(channel: string, ...args: any[]): void;
     _postMessage(channel: string, message: any, transfer?: any[]): void;
+    discardDOMConstraintRecording(): void;
+    getDOMConstraintData(deltaOnly?: boolean): Promise<Buffer>;
     outputDOMConstraintHTML(): void;
+    setDOMConstraintData(data: Buffer): void;
     setDOMConstraintHTML(html: string): void;
     setDOMConstraintMode(mode: string): void;
   }
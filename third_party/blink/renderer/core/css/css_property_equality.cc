@@ -6,9 +6,12 @@
 
 #include "third_party/blink/renderer/core/animation/property_handle.h"
 #include "third_party/blink/renderer/core/css/css_value.h"
+#include "third_party/blink/renderer/core/css/properties/css_property.h"
 #include "third_party/blink/renderer/core/style/computed_style.h"
+#include "third_party/blink/renderer/core/style/cursor_list.h"
 #include "third_party/blink/renderer/core/style/data_equivalency.h"
 #include "third_party/blink/renderer/core/style/shadow_list.h"
+#include "third_party/blink/renderer/platform/wtf/std_lib_extras.h"
 
 // TODO(ikilpatrick): generate this file.
 
@@ -58,6 +61,1027 @@ bool FillLayersEqual(const FillLayer& a_layers, const FillLayer& b_layers) {
   return true;
 }
 
+using PropertyComparator = bool (*)(const CSSProperty&,
+                                    const ComputedStyle&,
+                                    const ComputedStyle&);
+
+// Field comparators behind both PropertiesEqual() and
+// PropertiesEqualForDOMGuard(). Each one must only return true if the two
+// styles also serialize to the same computed value.
+#define PROPERTY_EQUAL(property_id)                                         \
+  bool PropertyEqual_##property_id(const CSSProperty&, const ComputedStyle& a, \
+                                   const ComputedStyle& b)
+
+PROPERTY_EQUAL(kBackgroundColor) {
+  return a.BackgroundColor() == b.BackgroundColor() &&
+         a.InternalVisitedBackgroundColor() ==
+             b.InternalVisitedBackgroundColor();
+}
+
+PROPERTY_EQUAL(kBackgroundImage) {
+  return FillLayersEqual<CSSPropertyID::kBackgroundImage>(
+      a.BackgroundLayers(), b.BackgroundLayers());
+}
+
+PROPERTY_EQUAL(kBackgroundPositionX) {
+  return FillLayersEqual<CSSPropertyID::kBackgroundPositionX>(
+      a.BackgroundLayers(), b.BackgroundLayers());
+}
+
+PROPERTY_EQUAL(kBackgroundPositionY) {
+  return FillLayersEqual<CSSPropertyID::kBackgroundPositionY>(
+      a.BackgroundLayers(), b.BackgroundLayers());
+}
+
+PROPERTY_EQUAL(kBackgroundSize) {
+  return FillLayersEqual<CSSPropertyID::kBackgroundSize>(
+      a.BackgroundLayers(), b.BackgroundLayers());
+}
+
+PROPERTY_EQUAL(kBaselineShift) {
+  return a.BaselineShiftValue() == b.BaselineShiftValue();
+}
+
+PROPERTY_EQUAL(kBorderBottomColor) {
+  return a.BorderBottomColor() == b.BorderBottomColor() &&
+         a.InternalVisitedBorderBottomColor() ==
+             b.InternalVisitedBorderBottomColor();
+}
+
+PROPERTY_EQUAL(kBorderBottomLeftRadius) {
+  return a.BorderBottomLeftRadius() == b.BorderBottomLeftRadius();
+}
+
+PROPERTY_EQUAL(kBorderBottomRightRadius) {
+  return a.BorderBottomRightRadius() == b.BorderBottomRightRadius();
+}
+
+PROPERTY_EQUAL(kBorderBottomWidth) {
+  return a.BorderBottomWidth() == b.BorderBottomWidth();
+}
+
+PROPERTY_EQUAL(kBorderImageOutset) {
+  return a.BorderImageOutset() == b.BorderImageOutset();
+}
+
+PROPERTY_EQUAL(kBorderImageSlice) {
+  return a.BorderImageSlices() == b.BorderImageSlices();
+}
+
+PROPERTY_EQUAL(kBorderImageSource) {
+  return DataEquivalent(a.BorderImageSource(), b.BorderImageSource());
+}
+
+PROPERTY_EQUAL(kBorderImageWidth) {
+  return a.BorderImageWidth() == b.BorderImageWidth();
+}
+
+PROPERTY_EQUAL(kBorderLeftColor) {
+  return a.BorderLeftColor() == b.BorderLeftColor() &&
+         a.InternalVisitedBorderLeftColor() ==
+             b.InternalVisitedBorderLeftColor();
+}
+
+PROPERTY_EQUAL(kBorderLeftWidth) {
+  return a.BorderLeftWidth() == b.BorderLeftWidth();
+}
+
+PROPERTY_EQUAL(kBorderRightColor) {
+  return a.BorderRightColor() == b.BorderRightColor() &&
+         a.InternalVisitedBorderRightColor() ==
+             b.InternalVisitedBorderRightColor();
+}
+
+PROPERTY_EQUAL(kBorderRightWidth) {
+  return a.BorderRightWidth() == b.BorderRightWidth();
+}
+
+PROPERTY_EQUAL(kBorderTopColor) {
+  return a.BorderTopColor() == b.BorderTopColor() &&
+         a.InternalVisitedBorderTopColor() ==
+             b.InternalVisitedBorderTopColor();
+}
+
+PROPERTY_EQUAL(kBorderTopLeftRadius) {
+  return a.BorderTopLeftRadius() == b.BorderTopLeftRadius();
+}
+
+PROPERTY_EQUAL(kBorderTopRightRadius) {
+  return a.BorderTopRightRadius() == b.BorderTopRightRadius();
+}
+
+PROPERTY_EQUAL(kBorderTopWidth) {
+  return a.BorderTopWidth() == b.BorderTopWidth();
+}
+
+PROPERTY_EQUAL(kBottom) {
+  return a.Bottom() == b.Bottom();
+}
+
+PROPERTY_EQUAL(kBoxShadow) {
+  return DataEquivalent(a.BoxShadow(), b.BoxShadow());
+}
+
+PROPERTY_EQUAL(kCaretColor) {
+  return a.CaretColor() == b.CaretColor() &&
+         a.InternalVisitedCaretColor() == b.InternalVisitedCaretColor();
+}
+
+PROPERTY_EQUAL(kClip) {
+  return a.Clip() == b.Clip();
+}
+
+PROPERTY_EQUAL(kColor) {
+  return a.GetColor() == b.GetColor() &&
+         a.InternalVisitedColor() == b.InternalVisitedColor();
+}
+
+PROPERTY_EQUAL(kFill) {
+  const SVGComputedStyle& a_svg = a.SvgStyle();
+  const SVGComputedStyle& b_svg = b.SvgStyle();
+  return a_svg.FillPaint().EqualTypeOrColor(b_svg.FillPaint()) &&
+         a_svg.InternalVisitedFillPaint().EqualTypeOrColor(
+             b_svg.InternalVisitedFillPaint());
+}
+
+PROPERTY_EQUAL(kFillOpacity) {
+  return a.FillOpacity() == b.FillOpacity();
+}
+
+PROPERTY_EQUAL(kFlexBasis) {
+  return a.FlexBasis() == b.FlexBasis();
+}
+
+PROPERTY_EQUAL(kFlexGrow) {
+  return a.FlexGrow() == b.FlexGrow();
+}
+
+PROPERTY_EQUAL(kFlexShrink) {
+  return a.FlexShrink() == b.FlexShrink();
+}
+
+PROPERTY_EQUAL(kFloodColor) {
+  return a.FloodColor() == b.FloodColor();
+}
+
+PROPERTY_EQUAL(kFloodOpacity) {
+  return a.FloodOpacity() == b.FloodOpacity();
+}
+
+PROPERTY_EQUAL(kFontSize) {
+  // CSSPropertyID::kFontSize: Must pass a specified size to setFontSize if
+  // Text Autosizing is enabled, but a computed size if text zoom is enabled
+  // (if neither is enabled it's irrelevant as they're probably the same).
+  // FIXME: Should we introduce an option to pass the computed font size
+  // here, allowing consumers to enable text zoom rather than Text
+  // Autosizing? See http://crbug.com/227545.
+  return a.SpecifiedFontSize() == b.SpecifiedFontSize();
+}
+
+PROPERTY_EQUAL(kFontSizeAdjust) {
+  return a.FontSizeAdjust() == b.FontSizeAdjust();
+}
+
+PROPERTY_EQUAL(kFontStretch) {
+  return a.GetFontStretch() == b.GetFontStretch();
+}
+
+PROPERTY_EQUAL(kFontVariationSettings) {
+  return DataEquivalent(a.GetFontDescription().VariationSettings(),
+                        b.GetFontDescription().VariationSettings());
+}
+
+PROPERTY_EQUAL(kFontWeight) {
+  return a.GetFontWeight() == b.GetFontWeight();
+}
+
+PROPERTY_EQUAL(kHeight) {
+  return a.Height() == b.Height();
+}
+
+PROPERTY_EQUAL(kLeft) {
+  return a.Left() == b.Left();
+}
+
+PROPERTY_EQUAL(kLetterSpacing) {
+  return a.LetterSpacing() == b.LetterSpacing();
+}
+
+PROPERTY_EQUAL(kLightingColor) {
+  return a.LightingColor() == b.LightingColor();
+}
+
+PROPERTY_EQUAL(kLineHeight) {
+  return a.SpecifiedLineHeight() == b.SpecifiedLineHeight();
+}
+
+PROPERTY_EQUAL(kTabSize) {
+  return a.GetTabSize() == b.GetTabSize();
+}
+
+PROPERTY_EQUAL(kListStyleImage) {
+  return DataEquivalent(a.ListStyleImage(), b.ListStyleImage());
+}
+
+PROPERTY_EQUAL(kMarginBottom) {
+  return a.MarginBottom() == b.MarginBottom();
+}
+
+PROPERTY_EQUAL(kMarginLeft) {
+  return a.MarginLeft() == b.MarginLeft();
+}
+
+PROPERTY_EQUAL(kMarginRight) {
+  return a.MarginRight() == b.MarginRight();
+}
+
+PROPERTY_EQUAL(kMarginTop) {
+  return a.MarginTop() == b.MarginTop();
+}
+
+PROPERTY_EQUAL(kMaxHeight) {
+  return a.MaxHeight() == b.MaxHeight();
+}
+
+PROPERTY_EQUAL(kMaxWidth) {
+  return a.MaxWidth() == b.MaxWidth();
+}
+
+PROPERTY_EQUAL(kMinHeight) {
+  return a.MinHeight() == b.MinHeight();
+}
+
+PROPERTY_EQUAL(kMinWidth) {
+  return a.MinWidth() == b.MinWidth();
+}
+
+PROPERTY_EQUAL(kObjectPosition) {
+  return a.ObjectPosition() == b.ObjectPosition();
+}
+
+PROPERTY_EQUAL(kOffsetAnchor) {
+  return a.OffsetAnchor() == b.OffsetAnchor();
+}
+
+PROPERTY_EQUAL(kOffsetDistance) {
+  return a.OffsetDistance() == b.OffsetDistance();
+}
+
+PROPERTY_EQUAL(kOffsetPath) {
+  return DataEquivalent(a.OffsetPath(), b.OffsetPath());
+}
+
+PROPERTY_EQUAL(kOffsetPosition) {
+  return a.OffsetPosition() == b.OffsetPosition();
+}
+
+PROPERTY_EQUAL(kOffsetRotate) {
+  return a.OffsetRotate() == b.OffsetRotate();
+}
+
+PROPERTY_EQUAL(kOpacity) {
+  return a.Opacity() == b.Opacity();
+}
+
+PROPERTY_EQUAL(kOrder) {
+  return a.Order() == b.Order();
+}
+
+PROPERTY_EQUAL(kOrphans) {
+  return a.Orphans() == b.Orphans();
+}
+
+PROPERTY_EQUAL(kOutlineColor) {
+  return a.OutlineColor() == b.OutlineColor() &&
+         a.InternalVisitedOutlineColor() == b.InternalVisitedOutlineColor();
+}
+
+PROPERTY_EQUAL(kOutlineOffset) {
+  return a.OutlineOffset() == b.OutlineOffset();
+}
+
+PROPERTY_EQUAL(kOutlineWidth) {
+  return a.OutlineWidth() == b.OutlineWidth();
+}
+
+PROPERTY_EQUAL(kPaddingBottom) {
+  return a.PaddingBottom() == b.PaddingBottom();
+}
+
+PROPERTY_EQUAL(kPaddingLeft) {
+  return a.PaddingLeft() == b.PaddingLeft();
+}
+
+PROPERTY_EQUAL(kPaddingRight) {
+  return a.PaddingRight() == b.PaddingRight();
+}
+
+PROPERTY_EQUAL(kPaddingTop) {
+  return a.PaddingTop() == b.PaddingTop();
+}
+
+PROPERTY_EQUAL(kRight) {
+  return a.Right() == b.Right();
+}
+
+PROPERTY_EQUAL(kShapeImageThreshold) {
+  return a.ShapeImageThreshold() == b.ShapeImageThreshold();
+}
+
+PROPERTY_EQUAL(kShapeMargin) {
+  return a.ShapeMargin() == b.ShapeMargin();
+}
+
+PROPERTY_EQUAL(kShapeOutside) {
+  return DataEquivalent(a.ShapeOutside(), b.ShapeOutside());
+}
+
+PROPERTY_EQUAL(kStopColor) {
+  return a.StopColor() == b.StopColor();
+}
+
+PROPERTY_EQUAL(kStopOpacity) {
+  return a.StopOpacity() == b.StopOpacity();
+}
+
+PROPERTY_EQUAL(kStroke) {
+  const SVGComputedStyle& a_svg = a.SvgStyle();
+  const SVGComputedStyle& b_svg = b.SvgStyle();
+  return a_svg.StrokePaint().EqualTypeOrColor(b_svg.StrokePaint()) &&
+         a_svg.InternalVisitedStrokePaint().EqualTypeOrColor(
+             b_svg.InternalVisitedStrokePaint());
+}
+
+PROPERTY_EQUAL(kStrokeDasharray) {
+  return a.StrokeDashArray() == b.StrokeDashArray();
+}
+
+PROPERTY_EQUAL(kStrokeDashoffset) {
+  return a.StrokeDashOffset() == b.StrokeDashOffset();
+}
+
+PROPERTY_EQUAL(kStrokeMiterlimit) {
+  return a.StrokeMiterLimit() == b.StrokeMiterLimit();
+}
+
+PROPERTY_EQUAL(kStrokeOpacity) {
+  return a.StrokeOpacity() == b.StrokeOpacity();
+}
+
+PROPERTY_EQUAL(kStrokeWidth) {
+  return a.StrokeWidth() == b.StrokeWidth();
+}
+
+PROPERTY_EQUAL(kTextDecorationColor) {
+  return a.TextDecorationColor() == b.TextDecorationColor() &&
+         a.InternalVisitedTextDecorationColor() ==
+             b.InternalVisitedTextDecorationColor();
+}
+
+PROPERTY_EQUAL(kTextDecorationSkipInk) {
+  return a.TextDecorationSkipInk() == b.TextDecorationSkipInk();
+}
+
+PROPERTY_EQUAL(kTextIndent) {
+  return a.TextIndent() == b.TextIndent();
+}
+
+PROPERTY_EQUAL(kTextShadow) {
+  return DataEquivalent(a.TextShadow(), b.TextShadow());
+}
+
+PROPERTY_EQUAL(kTextSizeAdjust) {
+  return a.GetTextSizeAdjust() == b.GetTextSizeAdjust();
+}
+
+PROPERTY_EQUAL(kTop) {
+  return a.Top() == b.Top();
+}
+
+PROPERTY_EQUAL(kVerticalAlign) {
+  return a.VerticalAlign() == b.VerticalAlign() &&
+         (a.VerticalAlign() != EVerticalAlign::kLength ||
+          a.GetVerticalAlignLength() == b.GetVerticalAlignLength());
+}
+
+PROPERTY_EQUAL(kVisibility) {
+  return a.Visibility() == b.Visibility();
+}
+
+PROPERTY_EQUAL(kWebkitBorderHorizontalSpacing) {
+  return a.HorizontalBorderSpacing() == b.HorizontalBorderSpacing();
+}
+
+PROPERTY_EQUAL(kWebkitBorderVerticalSpacing) {
+  return a.VerticalBorderSpacing() == b.VerticalBorderSpacing();
+}
+
+PROPERTY_EQUAL(kClipPath) {
+  return DataEquivalent(a.ClipPath(), b.ClipPath());
+}
+
+PROPERTY_EQUAL(kColumnCount) {
+  return a.ColumnCount() == b.ColumnCount();
+}
+
+PROPERTY_EQUAL(kColumnGap) {
+  return a.ColumnGap() == b.ColumnGap();
+}
+
+PROPERTY_EQUAL(kRowGap) {
+  return a.RowGap() == b.RowGap();
+}
+
+PROPERTY_EQUAL(kColumnRuleColor) {
+  return a.ColumnRuleColor() == b.ColumnRuleColor() &&
+         a.InternalVisitedColumnRuleColor() ==
+             b.InternalVisitedColumnRuleColor();
+}
+
+PROPERTY_EQUAL(kColumnRuleWidth) {
+  return a.ColumnRuleWidth() == b.ColumnRuleWidth();
+}
+
+PROPERTY_EQUAL(kColumnWidth) {
+  return a.ColumnWidth() == b.ColumnWidth();
+}
+
+PROPERTY_EQUAL(kFilter) {
+  return a.Filter() == b.Filter();
+}
+
+PROPERTY_EQUAL(kBackdropFilter) {
+  return a.BackdropFilter() == b.BackdropFilter();
+}
+
+PROPERTY_EQUAL(kWebkitMaskBoxImageOutset) {
+  return a.MaskBoxImageOutset() == b.MaskBoxImageOutset();
+}
+
+PROPERTY_EQUAL(kWebkitMaskBoxImageSlice) {
+  return a.MaskBoxImageSlices() == b.MaskBoxImageSlices();
+}
+
+PROPERTY_EQUAL(kWebkitMaskBoxImageSource) {
+  return DataEquivalent(a.MaskBoxImageSource(), b.MaskBoxImageSource());
+}
+
+PROPERTY_EQUAL(kWebkitMaskBoxImageWidth) {
+  return a.MaskBoxImageWidth() == b.MaskBoxImageWidth();
+}
+
+PROPERTY_EQUAL(kWebkitMaskImage) {
+  return DataEquivalent(a.MaskImage(), b.MaskImage());
+}
+
+PROPERTY_EQUAL(kWebkitMaskPositionX) {
+  return FillLayersEqual<CSSPropertyID::kWebkitMaskPositionX>(
+      a.MaskLayers(), b.MaskLayers());
+}
+
+PROPERTY_EQUAL(kWebkitMaskPositionY) {
+  return FillLayersEqual<CSSPropertyID::kWebkitMaskPositionY>(
+      a.MaskLayers(), b.MaskLayers());
+}
+
+PROPERTY_EQUAL(kWebkitMaskSize) {
+  return FillLayersEqual<CSSPropertyID::kWebkitMaskSize>(a.MaskLayers(),
+                                                         b.MaskLayers());
+}
+
+PROPERTY_EQUAL(kPerspective) {
+  return a.Perspective() == b.Perspective();
+}
+
+PROPERTY_EQUAL(kPerspectiveOrigin) {
+  return a.PerspectiveOriginX() == b.PerspectiveOriginX() &&
+         a.PerspectiveOriginY() == b.PerspectiveOriginY();
+}
+
+PROPERTY_EQUAL(kWebkitTextStrokeColor) {
+  return a.TextStrokeColor() == b.TextStrokeColor() &&
+         a.InternalVisitedTextStrokeColor() ==
+             b.InternalVisitedTextStrokeColor();
+}
+
+PROPERTY_EQUAL(kTransform) {
+  return a.Transform() == b.Transform();
+}
+
+PROPERTY_EQUAL(kTranslate) {
+  return DataEquivalent<TransformOperation>(a.Translate(), b.Translate());
+}
+
+PROPERTY_EQUAL(kRotate) {
+  return DataEquivalent<TransformOperation>(a.Rotate(), b.Rotate());
+}
+
+PROPERTY_EQUAL(kScale) {
+  return DataEquivalent<TransformOperation>(a.Scale(), b.Scale());
+}
+
+PROPERTY_EQUAL(kTransformOrigin) {
+  return a.TransformOriginX() == b.TransformOriginX() &&
+         a.TransformOriginY() == b.TransformOriginY() &&
+         a.TransformOriginZ() == b.TransformOriginZ();
+}
+
+PROPERTY_EQUAL(kWebkitPerspectiveOriginX) {
+  return a.PerspectiveOriginX() == b.PerspectiveOriginX();
+}
+
+PROPERTY_EQUAL(kWebkitPerspectiveOriginY) {
+  return a.PerspectiveOriginY() == b.PerspectiveOriginY();
+}
+
+PROPERTY_EQUAL(kWebkitTransformOriginX) {
+  return a.TransformOriginX() == b.TransformOriginX();
+}
+
+PROPERTY_EQUAL(kWebkitTransformOriginY) {
+  return a.TransformOriginY() == b.TransformOriginY();
+}
+
+PROPERTY_EQUAL(kWebkitTransformOriginZ) {
+  return a.TransformOriginZ() == b.TransformOriginZ();
+}
+
+PROPERTY_EQUAL(kWidows) {
+  return a.Widows() == b.Widows();
+}
+
+PROPERTY_EQUAL(kWidth) {
+  return a.Width() == b.Width();
+}
+
+PROPERTY_EQUAL(kWordSpacing) {
+  return a.WordSpacing() == b.WordSpacing();
+}
+
+PROPERTY_EQUAL(kD) {
+  return DataEquivalent(a.SvgStyle().D(), b.SvgStyle().D());
+}
+
+PROPERTY_EQUAL(kCx) {
+  return a.SvgStyle().Cx() == b.SvgStyle().Cx();
+}
+
+PROPERTY_EQUAL(kCy) {
+  return a.SvgStyle().Cy() == b.SvgStyle().Cy();
+}
+
+PROPERTY_EQUAL(kX) {
+  return a.SvgStyle().X() == b.SvgStyle().X();
+}
+
+PROPERTY_EQUAL(kY) {
+  return a.SvgStyle().Y() == b.SvgStyle().Y();
+}
+
+PROPERTY_EQUAL(kR) {
+  return a.SvgStyle().R() == b.SvgStyle().R();
+}
+
+PROPERTY_EQUAL(kRx) {
+  return a.SvgStyle().Rx() == b.SvgStyle().Rx();
+}
+
+PROPERTY_EQUAL(kRy) {
+  return a.SvgStyle().Ry() == b.SvgStyle().Ry();
+}
+
+PROPERTY_EQUAL(kZIndex) {
+  return a.HasAutoZIndex() == b.HasAutoZIndex() &&
+         (a.HasAutoZIndex() || a.ZIndex() == b.ZIndex());
+}
+
+PROPERTY_EQUAL(kContainIntrinsicSize) {
+  return a.ContainIntrinsicSize() == b.ContainIntrinsicSize();
+}
+
+PROPERTY_EQUAL(kAspectRatio) {
+  return a.AspectRatio() == b.AspectRatio();
+}
+
+PROPERTY_EQUAL(kMathDepth) {
+  return a.MathDepth() == b.MathDepth();
+}
+
+// Keyword properties; their computed values are the stored enums, or the
+// alignment and cursor data they serialize from.
+
+PROPERTY_EQUAL(kAlignContent) {
+  return a.AlignContent() == b.AlignContent();
+}
+
+PROPERTY_EQUAL(kAlignItems) {
+  return a.AlignItems() == b.AlignItems();
+}
+
+PROPERTY_EQUAL(kAlignSelf) {
+  return a.AlignSelf() == b.AlignSelf();
+}
+
+PROPERTY_EQUAL(kBorderBottomStyle) {
+  return a.BorderBottomStyle() == b.BorderBottomStyle();
+}
+
+PROPERTY_EQUAL(kBorderCollapse) {
+  return a.BorderCollapse() == b.BorderCollapse();
+}
+
+PROPERTY_EQUAL(kBorderLeftStyle) {
+  return a.BorderLeftStyle() == b.BorderLeftStyle();
+}
+
+PROPERTY_EQUAL(kBorderRightStyle) {
+  return a.BorderRightStyle() == b.BorderRightStyle();
+}
+
+PROPERTY_EQUAL(kBorderTopStyle) {
+  return a.BorderTopStyle() == b.BorderTopStyle();
+}
+
+PROPERTY_EQUAL(kBoxSizing) {
+  return a.BoxSizing() == b.BoxSizing();
+}
+
+PROPERTY_EQUAL(kClear) {
+  return a.Clear() == b.Clear();
+}
+
+PROPERTY_EQUAL(kCursor) {
+  return a.Cursor() == b.Cursor() && DataEquivalent(a.Cursors(), b.Cursors());
+}
+
+PROPERTY_EQUAL(kDirection) {
+  return a.Direction() == b.Direction();
+}
+
+PROPERTY_EQUAL(kDisplay) {
+  return a.Display() == b.Display() &&
+         a.DisplayLayoutCustomName() == b.DisplayLayoutCustomName();
+}
+
+PROPERTY_EQUAL(kFlexDirection) {
+  return a.FlexDirection() == b.FlexDirection();
+}
+
+PROPERTY_EQUAL(kFlexWrap) {
+  return a.FlexWrap() == b.FlexWrap();
+}
+
+PROPERTY_EQUAL(kFloat) {
+  return a.Floating() == b.Floating();
+}
+
+PROPERTY_EQUAL(kFontStyle) {
+  return a.GetFontDescription().Style() == b.GetFontDescription().Style();
+}
+
+PROPERTY_EQUAL(kJustifyContent) {
+  return a.JustifyContent() == b.JustifyContent();
+}
+
+PROPERTY_EQUAL(kJustifyItems) {
+  return a.JustifyItems() == b.JustifyItems();
+}
+
+PROPERTY_EQUAL(kJustifySelf) {
+  return a.JustifySelf() == b.JustifySelf();
+}
+
+PROPERTY_EQUAL(kListStylePosition) {
+  return a.ListStylePosition() == b.ListStylePosition();
+}
+
+PROPERTY_EQUAL(kObjectFit) {
+  return a.GetObjectFit() == b.GetObjectFit();
+}
+
+PROPERTY_EQUAL(kOutlineStyle) {
+  return a.OutlineStyle() == b.OutlineStyle() &&
+         a.OutlineStyleIsAuto() == b.OutlineStyleIsAuto();
+}
+
+PROPERTY_EQUAL(kOverflowWrap) {
+  return a.OverflowWrap() == b.OverflowWrap();
+}
+
+PROPERTY_EQUAL(kOverflowX) {
+  return a.OverflowX() == b.OverflowX();
+}
+
+PROPERTY_EQUAL(kOverflowY) {
+  return a.OverflowY() == b.OverflowY();
+}
+
+PROPERTY_EQUAL(kPointerEvents) {
+  return a.PointerEvents() == b.PointerEvents();
+}
+
+PROPERTY_EQUAL(kPosition) {
+  return a.GetPosition() == b.GetPosition();
+}
+
+PROPERTY_EQUAL(kResize) {
+  return a.Resize() == b.Resize();
+}
+
+PROPERTY_EQUAL(kTableLayout) {
+  return a.TableLayout() == b.TableLayout();
+}
+
+PROPERTY_EQUAL(kTextAlign) {
+  return a.GetTextAlign() == b.GetTextAlign();
+}
+
+PROPERTY_EQUAL(kTextDecorationLine) {
+  return a.GetTextDecoration() == b.GetTextDecoration();
+}
+
+PROPERTY_EQUAL(kTextDecorationStyle) {
+  return a.TextDecorationStyle() == b.TextDecorationStyle();
+}
+
+PROPERTY_EQUAL(kTextOverflow) {
+  return a.TextOverflow() == b.TextOverflow();
+}
+
+PROPERTY_EQUAL(kTextTransform) {
+  return a.TextTransform() == b.TextTransform();
+}
+
+PROPERTY_EQUAL(kUserSelect) {
+  return a.UserSelect() == b.UserSelect();
+}
+
+PROPERTY_EQUAL(kWhiteSpace) {
+  return a.WhiteSpace() == b.WhiteSpace();
+}
+
+PROPERTY_EQUAL(kWordBreak) {
+  return a.WordBreak() == b.WordBreak();
+}
+
+#undef PROPERTY_EQUAL
+
+bool ComputedValuesEqual(const CSSProperty& property,
+                         const ComputedStyle& a,
+                         const ComputedStyle& b) {
+  return property.ComputedValuesEqual(a, b);
+}
+
+struct PropertyComparatorEntry {
+  CSSPropertyID property_id;
+  PropertyComparator comparator;
+};
+
+#define PROPERTY_ENTRY(property_id) \
+  { CSSPropertyID::property_id, &PropertyEqual_##property_id }
+
+constexpr PropertyComparatorEntry kPropertyComparatorEntries[] = {
+    PROPERTY_ENTRY(kBackgroundColor),
+    PROPERTY_ENTRY(kBackgroundImage),
+    PROPERTY_ENTRY(kBackgroundPositionX),
+    PROPERTY_ENTRY(kBackgroundPositionY),
+    PROPERTY_ENTRY(kBackgroundSize),
+    PROPERTY_ENTRY(kBaselineShift),
+    PROPERTY_ENTRY(kBorderBottomColor),
+    PROPERTY_ENTRY(kBorderBottomLeftRadius),
+    PROPERTY_ENTRY(kBorderBottomRightRadius),
+    PROPERTY_ENTRY(kBorderBottomWidth),
+    PROPERTY_ENTRY(kBorderImageOutset),
+    PROPERTY_ENTRY(kBorderImageSlice),
+    PROPERTY_ENTRY(kBorderImageSource),
+    PROPERTY_ENTRY(kBorderImageWidth),
+    PROPERTY_ENTRY(kBorderLeftColor),
+    PROPERTY_ENTRY(kBorderLeftWidth),
+    PROPERTY_ENTRY(kBorderRightColor),
+    PROPERTY_ENTRY(kBorderRightWidth),
+    PROPERTY_ENTRY(kBorderTopColor),
+    PROPERTY_ENTRY(kBorderTopLeftRadius),
+    PROPERTY_ENTRY(kBorderTopRightRadius),
+    PROPERTY_ENTRY(kBorderTopWidth),
+    PROPERTY_ENTRY(kBottom),
+    PROPERTY_ENTRY(kBoxShadow),
+    PROPERTY_ENTRY(kCaretColor),
+    PROPERTY_ENTRY(kClip),
+    PROPERTY_ENTRY(kColor),
+    PROPERTY_ENTRY(kFill),
+    PROPERTY_ENTRY(kFillOpacity),
+    PROPERTY_ENTRY(kFlexBasis),
+    PROPERTY_ENTRY(kFlexGrow),
+    PROPERTY_ENTRY(kFlexShrink),
+    PROPERTY_ENTRY(kFloodColor),
+    PROPERTY_ENTRY(kFloodOpacity),
+    PROPERTY_ENTRY(kFontSize),
+    PROPERTY_ENTRY(kFontSizeAdjust),
+    PROPERTY_ENTRY(kFontStretch),
+    PROPERTY_ENTRY(kFontVariationSettings),
+    PROPERTY_ENTRY(kFontWeight),
+    PROPERTY_ENTRY(kHeight),
+    PROPERTY_ENTRY(kLeft),
+    PROPERTY_ENTRY(kLetterSpacing),
+    PROPERTY_ENTRY(kLightingColor),
+    PROPERTY_ENTRY(kLineHeight),
+    PROPERTY_ENTRY(kTabSize),
+    PROPERTY_ENTRY(kListStyleImage),
+    PROPERTY_ENTRY(kMarginBottom),
+    PROPERTY_ENTRY(kMarginLeft),
+    PROPERTY_ENTRY(kMarginRight),
+    PROPERTY_ENTRY(kMarginTop),
+    PROPERTY_ENTRY(kMaxHeight),
+    PROPERTY_ENTRY(kMaxWidth),
+    PROPERTY_ENTRY(kMinHeight),
+    PROPERTY_ENTRY(kMinWidth),
+    PROPERTY_ENTRY(kObjectPosition),
+    PROPERTY_ENTRY(kOffsetAnchor),
+    PROPERTY_ENTRY(kOffsetDistance),
+    PROPERTY_ENTRY(kOffsetPath),
+    PROPERTY_ENTRY(kOffsetPosition),
+    PROPERTY_ENTRY(kOffsetRotate),
+    PROPERTY_ENTRY(kOpacity),
+    PROPERTY_ENTRY(kOrder),
+    PROPERTY_ENTRY(kOrphans),
+    PROPERTY_ENTRY(kOutlineColor),
+    PROPERTY_ENTRY(kOutlineOffset),
+    PROPERTY_ENTRY(kOutlineWidth),
+    PROPERTY_ENTRY(kPaddingBottom),
+    PROPERTY_ENTRY(kPaddingLeft),
+    PROPERTY_ENTRY(kPaddingRight),
+    PROPERTY_ENTRY(kPaddingTop),
+    PROPERTY_ENTRY(kRight),
+    PROPERTY_ENTRY(kShapeImageThreshold),
+    PROPERTY_ENTRY(kShapeMargin),
+    PROPERTY_ENTRY(kShapeOutside),
+    PROPERTY_ENTRY(kStopColor),
+    PROPERTY_ENTRY(kStopOpacity),
+    PROPERTY_ENTRY(kStroke),
+    PROPERTY_ENTRY(kStrokeDasharray),
+    PROPERTY_ENTRY(kStrokeDashoffset),
+    PROPERTY_ENTRY(kStrokeMiterlimit),
+    PROPERTY_ENTRY(kStrokeOpacity),
+    PROPERTY_ENTRY(kStrokeWidth),
+    PROPERTY_ENTRY(kTextDecorationColor),
+    PROPERTY_ENTRY(kTextDecorationSkipInk),
+    PROPERTY_ENTRY(kTextIndent),
+    PROPERTY_ENTRY(kTextShadow),
+    PROPERTY_ENTRY(kTextSizeAdjust),
+    PROPERTY_ENTRY(kTop),
+    PROPERTY_ENTRY(kVerticalAlign),
+    PROPERTY_ENTRY(kVisibility),
+    PROPERTY_ENTRY(kWebkitBorderHorizontalSpacing),
+    PROPERTY_ENTRY(kWebkitBorderVerticalSpacing),
+    PROPERTY_ENTRY(kClipPath),
+    PROPERTY_ENTRY(kColumnCount),
+    PROPERTY_ENTRY(kColumnGap),
+    PROPERTY_ENTRY(kRowGap),
+    PROPERTY_ENTRY(kColumnRuleColor),
+    PROPERTY_ENTRY(kColumnRuleWidth),
+    PROPERTY_ENTRY(kColumnWidth),
+    PROPERTY_ENTRY(kFilter),
+    PROPERTY_ENTRY(kBackdropFilter),
+    PROPERTY_ENTRY(kWebkitMaskBoxImageOutset),
+    PROPERTY_ENTRY(kWebkitMaskBoxImageSlice),
+    PROPERTY_ENTRY(kWebkitMaskBoxImageSource),
+    PROPERTY_ENTRY(kWebkitMaskBoxImageWidth),
+    PROPERTY_ENTRY(kWebkitMaskImage),
+    PROPERTY_ENTRY(kWebkitMaskPositionX),
+    PROPERTY_ENTRY(kWebkitMaskPositionY),
+    PROPERTY_ENTRY(kWebkitMaskSize),
+    PROPERTY_ENTRY(kPerspective),
+    PROPERTY_ENTRY(kPerspectiveOrigin),
+    PROPERTY_ENTRY(kWebkitTextStrokeColor),
+    PROPERTY_ENTRY(kTransform),
+    PROPERTY_ENTRY(kTranslate),
+    PROPERTY_ENTRY(kRotate),
+    PROPERTY_ENTRY(kScale),
+    PROPERTY_ENTRY(kTransformOrigin),
+    PROPERTY_ENTRY(kWebkitPerspectiveOriginX),
+    PROPERTY_ENTRY(kWebkitPerspectiveOriginY),
+    PROPERTY_ENTRY(kWebkitTransformOriginX),
+    PROPERTY_ENTRY(kWebkitTransformOriginY),
+    PROPERTY_ENTRY(kWebkitTransformOriginZ),
+    PROPERTY_ENTRY(kWidows),
+    PROPERTY_ENTRY(kWidth),
+    PROPERTY_ENTRY(kWordSpacing),
+    PROPERTY_ENTRY(kD),
+    PROPERTY_ENTRY(kCx),
+    PROPERTY_ENTRY(kCy),
+    PROPERTY_ENTRY(kX),
+    PROPERTY_ENTRY(kY),
+    PROPERTY_ENTRY(kR),
+    PROPERTY_ENTRY(kRx),
+    PROPERTY_ENTRY(kRy),
+    PROPERTY_ENTRY(kZIndex),
+    PROPERTY_ENTRY(kContainIntrinsicSize),
+    PROPERTY_ENTRY(kAspectRatio),
+    PROPERTY_ENTRY(kMathDepth),
+    PROPERTY_ENTRY(kAlignContent),
+    PROPERTY_ENTRY(kAlignItems),
+    PROPERTY_ENTRY(kAlignSelf),
+    PROPERTY_ENTRY(kBorderBottomStyle),
+    PROPERTY_ENTRY(kBorderCollapse),
+    PROPERTY_ENTRY(kBorderLeftStyle),
+    PROPERTY_ENTRY(kBorderRightStyle),
+    PROPERTY_ENTRY(kBorderTopStyle),
+    PROPERTY_ENTRY(kBoxSizing),
+    PROPERTY_ENTRY(kClear),
+    PROPERTY_ENTRY(kCursor),
+    PROPERTY_ENTRY(kDirection),
+    PROPERTY_ENTRY(kDisplay),
+    PROPERTY_ENTRY(kFlexDirection),
+    PROPERTY_ENTRY(kFlexWrap),
+    PROPERTY_ENTRY(kFloat),
+    PROPERTY_ENTRY(kFontStyle),
+    PROPERTY_ENTRY(kJustifyContent),
+    PROPERTY_ENTRY(kJustifyItems),
+    PROPERTY_ENTRY(kJustifySelf),
+    PROPERTY_ENTRY(kListStylePosition),
+    PROPERTY_ENTRY(kObjectFit),
+    PROPERTY_ENTRY(kOutlineStyle),
+    PROPERTY_ENTRY(kOverflowWrap),
+    PROPERTY_ENTRY(kOverflowX),
+    PROPERTY_ENTRY(kOverflowY),
+    PROPERTY_ENTRY(kPointerEvents),
+    PROPERTY_ENTRY(kPosition),
+    PROPERTY_ENTRY(kResize),
+    PROPERTY_ENTRY(kTableLayout),
+    PROPERTY_ENTRY(kTextAlign),
+    PROPERTY_ENTRY(kTextDecorationLine),
+    PROPERTY_ENTRY(kTextDecorationStyle),
+    PROPERTY_ENTRY(kTextOverflow),
+    PROPERTY_ENTRY(kTextTransform),
+    PROPERTY_ENTRY(kUserSelect),
+    PROPERTY_ENTRY(kWhiteSpace),
+    PROPERTY_ENTRY(kWordBreak),
+};
+
+#undef PROPERTY_ENTRY
+
+// Properties that PropertiesEqualForDOMGuard() deliberately leaves to the
+// serialized comparison: their computed values are lists, maps or strings that
+// are compared as cheaply through the interned CssText() as field by field.
+// Any other property without a comparator is a gap to fill, not a choice.
+constexpr CSSPropertyID kSerializedComparisonProperties[] = {
+    CSSPropertyID::kAnimationName,       CSSPropertyID::kContent,
+    CSSPropertyID::kCounterIncrement,    CSSPropertyID::kCounterReset,
+    CSSPropertyID::kCounterSet,          CSSPropertyID::kFontFamily,
+    CSSPropertyID::kFontFeatureSettings, CSSPropertyID::kGridTemplateAreas,
+    CSSPropertyID::kGridTemplateColumns, CSSPropertyID::kGridTemplateRows,
+    CSSPropertyID::kQuotes,              CSSPropertyID::kTransitionProperty,
+    CSSPropertyID::kWillChange,
+};
+
+// Dense tables indexed by CSSPropertyID. The field table only holds the
+// comparators above. The DOMGuard table falls back to the ComputedValuesEqual()
+// generated from css_properties.json5 where there is no field comparator, and
+// to nullptr (serialized comparison) where there is neither, which should only
+// be the kSerializedComparisonProperties.
+class PropertyComparatorTable {
+  USING_FAST_MALLOC(PropertyComparatorTable);
+
+ public:
+  PropertyComparatorTable() {
+    for (CSSPropertyID property_id : CSSPropertyIDList()) {
+      if (CSSProperty::Get(property_id).IsComputedValueComparable()) {
+        dom_guard_comparators_[static_cast<size_t>(property_id)] =
+            &ComputedValuesEqual;
+      }
+    }
+    for (const PropertyComparatorEntry& entry : kPropertyComparatorEntries) {
+      field_comparators_[static_cast<size_t>(entry.property_id)] =
+          entry.comparator;
+      dom_guard_comparators_[static_cast<size_t>(entry.property_id)] =
+          entry.comparator;
+    }
+#if DCHECK_IS_ON()
+    // A property that gains a comparator must leave the list.
+    for (CSSPropertyID property_id : kSerializedComparisonProperties) {
+      DCHECK(!dom_guard_comparators_[static_cast<size_t>(property_id)])
+          << CSSProperty::Get(property_id).GetPropertyNameString();
+    }
+#endif
+  }
+
+  PropertyComparator FieldComparator(CSSPropertyID property_id) const {
+    return field_comparators_[static_cast<size_t>(property_id)];
+  }
+  PropertyComparator DOMGuardComparator(CSSPropertyID property_id) const {
+    return dom_guard_comparators_[static_cast<size_t>(property_id)];
+  }
+
+ private:
+  PropertyComparator field_comparators_[kNumCSSPropertyIDs] = {};
+  PropertyComparator dom_guard_comparators_[kNumCSSPropertyIDs] = {};
+};
+
+const PropertyComparatorTable& GetPropertyComparatorTable() {
+  DEFINE_STATIC_LOCAL(const PropertyComparatorTable, table, ());
+  return table;
+}
+
 }  // namespace
 
 bool CSSPropertyEquality::PropertiesEqual(const PropertyHandle& property,
@@ -67,667 +1091,22 @@ bool CSSPropertyEquality::PropertiesEqual(const PropertyHandle& property,
     const AtomicString& name = property.CustomPropertyName();
     return DataEquivalent(a.GetVariableValue(name), b.GetVariableValue(name));
   }
-  switch (property.GetCSSProperty().PropertyID()) {
-    case CSSPropertyID::kBackgroundColor:
-      return a.BackgroundColor() == b.BackgroundColor() &&
-             a.InternalVisitedBackgroundColor() ==
-                 b.InternalVisitedBackgroundColor();
-    case CSSPropertyID::kBackgroundImage:
-      return FillLayersEqual<CSSPropertyID::kBackgroundImage>(
-          a.BackgroundLayers(), b.BackgroundLayers());
-    case CSSPropertyID::kBackgroundPositionX:
-      return FillLayersEqual<CSSPropertyID::kBackgroundPositionX>(
-          a.BackgroundLayers(), b.BackgroundLayers());
-    case CSSPropertyID::kBackgroundPositionY:
-      return FillLayersEqual<CSSPropertyID::kBackgroundPositionY>(
-          a.BackgroundLayers(), b.BackgroundLayers());
-    case CSSPropertyID::kBackgroundSize:
-      return FillLayersEqual<CSSPropertyID::kBackgroundSize>(
-          a.BackgroundLayers(), b.BackgroundLayers());
-    case CSSPropertyID::kBaselineShift:
-      return a.BaselineShiftValue() == b.BaselineShiftValue();
-    case CSSPropertyID::kBorderBottomColor:
-      return a.BorderBottomColor() == b.BorderBottomColor() &&
-             a.InternalVisitedBorderBottomColor() ==
-                 b.InternalVisitedBorderBottomColor();
-    case CSSPropertyID::kBorderBottomLeftRadius:
-      return a.BorderBottomLeftRadius() == b.BorderBottomLeftRadius();
-    case CSSPropertyID::kBorderBottomRightRadius:
-      return a.BorderBottomRightRadius() == b.BorderBottomRightRadius();
-    case CSSPropertyID::kBorderBottomWidth:
-      return a.BorderBottomWidth() == b.BorderBottomWidth();
-    case CSSPropertyID::kBorderImageOutset:
-      return a.BorderImageOutset() == b.BorderImageOutset();
-    case CSSPropertyID::kBorderImageSlice:
-      return a.BorderImageSlices() == b.BorderImageSlices();
-    case CSSPropertyID::kBorderImageSource:
-      return DataEquivalent(a.BorderImageSource(), b.BorderImageSource());
-    case CSSPropertyID::kBorderImageWidth:
-      return a.BorderImageWidth() == b.BorderImageWidth();
-    case CSSPropertyID::kBorderLeftColor:
-      return a.BorderLeftColor() == b.BorderLeftColor() &&
-             a.InternalVisitedBorderLeftColor() ==
-                 b.InternalVisitedBorderLeftColor();
-    case CSSPropertyID::kBorderLeftWidth:
-      return a.BorderLeftWidth() == b.BorderLeftWidth();
-    case CSSPropertyID::kBorderRightColor:
-      return a.BorderRightColor() == b.BorderRightColor() &&
-             a.InternalVisitedBorderRightColor() ==
-                 b.InternalVisitedBorderRightColor();
-    case CSSPropertyID::kBorderRightWidth:
-      return a.BorderRightWidth() == b.BorderRightWidth();
-    case CSSPropertyID::kBorderTopColor:
-      return a.BorderTopColor() == b.BorderTopColor() &&
-             a.InternalVisitedBorderTopColor() ==
-                 b.InternalVisitedBorderTopColor();
-    case CSSPropertyID::kBorderTopLeftRadius:
-      return a.BorderTopLeftRadius() == b.BorderTopLeftRadius();
-    case CSSPropertyID::kBorderTopRightRadius:
-      return a.BorderTopRightRadius() == b.BorderTopRightRadius();
-    case CSSPropertyID::kBorderTopWidth:
-      return a.BorderTopWidth() == b.BorderTopWidth();
-    case CSSPropertyID::kBottom:
-      return a.Bottom() == b.Bottom();
-    case CSSPropertyID::kBoxShadow:
-      return DataEquivalent(a.BoxShadow(), b.BoxShadow());
-    case CSSPropertyID::kCaretColor:
-      return a.CaretColor() == b.CaretColor() &&
-             a.InternalVisitedCaretColor() == b.InternalVisitedCaretColor();
-    case CSSPropertyID::kClip:
-      return a.Clip() == b.Clip();
-    case CSSPropertyID::kColor:
-      return a.GetColor() == b.GetColor() &&
-             a.InternalVisitedColor() == b.InternalVisitedColor();
-    case CSSPropertyID::kFill: {
-      const SVGComputedStyle& a_svg = a.SvgStyle();
-      const SVGComputedStyle& b_svg = b.SvgStyle();
-      return a_svg.FillPaint().EqualTypeOrColor(b_svg.FillPaint()) &&
-             a_svg.InternalVisitedFillPaint().EqualTypeOrColor(
-                 b_svg.InternalVisitedFillPaint());
-    }
-    case CSSPropertyID::kFillOpacity:
-      return a.FillOpacity() == b.FillOpacity();
-    case CSSPropertyID::kFlexBasis:
-      return a.FlexBasis() == b.FlexBasis();
-    case CSSPropertyID::kFlexGrow:
-      return a.FlexGrow() == b.FlexGrow();
-    case CSSPropertyID::kFlexShrink:
-      return a.FlexShrink() == b.FlexShrink();
-    case CSSPropertyID::kFloodColor:
-      return a.FloodColor() == b.FloodColor();
-    case CSSPropertyID::kFloodOpacity:
-      return a.FloodOpacity() == b.FloodOpacity();
-    case CSSPropertyID::kFontSize:
-      // CSSPropertyID::kFontSize: Must pass a specified size to setFontSize if
-      // Text Autosizing is enabled, but a computed size if text zoom is enabled
-      // (if neither is enabled it's irrelevant as they're probably the same).
-      // FIXME: Should we introduce an option to pass the computed font size
-      // here, allowing consumers to enable text zoom rather than Text
-      // Autosizing? See http://crbug.com/227545.
-      return a.SpecifiedFontSize() == b.SpecifiedFontSize();
-    case CSSPropertyID::kFontSizeAdjust:
-      return a.FontSizeAdjust() == b.FontSizeAdjust();
-    case CSSPropertyID::kFontStretch:
-      return a.GetFontStretch() == b.GetFontStretch();
-    case CSSPropertyID::kFontVariationSettings:
-      return DataEquivalent(a.GetFontDescription().VariationSettings(),
-                            b.GetFontDescription().VariationSettings());
-    case CSSPropertyID::kFontWeight:
-      return a.GetFontWeight() == b.GetFontWeight();
-    case CSSPropertyID::kHeight:
-      return a.Height() == b.Height();
-    case CSSPropertyID::kLeft:
-      return a.Left() == b.Left();
-    case CSSPropertyID::kLetterSpacing:
-      return a.LetterSpacing() == b.LetterSpacing();
-    case CSSPropertyID::kLightingColor:
-      return a.LightingColor() == b.LightingColor();
-    case CSSPropertyID::kLineHeight:
-      return a.SpecifiedLineHeight() == b.SpecifiedLineHeight();
-    case CSSPropertyID::kTabSize:
-      return a.GetTabSize() == b.GetTabSize();
-    case CSSPropertyID::kListStyleImage:
-      return DataEquivalent(a.ListStyleImage(), b.ListStyleImage());
-    case CSSPropertyID::kMarginBottom:
-      return a.MarginBottom() == b.MarginBottom();
-    case CSSPropertyID::kMarginLeft:
-      return a.MarginLeft() == b.MarginLeft();
-    case CSSPropertyID::kMarginRight:
-      return a.MarginRight() == b.MarginRight();
-    case CSSPropertyID::kMarginTop:
-      return a.MarginTop() == b.MarginTop();
-    case CSSPropertyID::kMaxHeight:
-      return a.MaxHeight() == b.MaxHeight();
-    case CSSPropertyID::kMaxWidth:
-      return a.MaxWidth() == b.MaxWidth();
-    case CSSPropertyID::kMinHeight:
-      return a.MinHeight() == b.MinHeight();
-    case CSSPropertyID::kMinWidth:
-      return a.MinWidth() == b.MinWidth();
-    case CSSPropertyID::kObjectPosition:
-      return a.ObjectPosition() == b.ObjectPosition();
-    case CSSPropertyID::kOffsetAnchor:
-      return a.OffsetAnchor() == b.OffsetAnchor();
-    case CSSPropertyID::kOffsetDistance:
-      return a.OffsetDistance() == b.OffsetDistance();
-    case CSSPropertyID::kOffsetPath:
-      return DataEquivalent(a.OffsetPath(), b.OffsetPath());
-    case CSSPropertyID::kOffsetPosition:
-      return a.OffsetPosition() == b.OffsetPosition();
-    case CSSPropertyID::kOffsetRotate:
-      return a.OffsetRotate() == b.OffsetRotate();
-    case CSSPropertyID::kOpacity:
-      return a.Opacity() == b.Opacity();
-    case CSSPropertyID::kOrder:
-      return a.Order() == b.Order();
-    case CSSPropertyID::kOrphans:
-      return a.Orphans() == b.Orphans();
-    case CSSPropertyID::kOutlineColor:
-      return a.OutlineColor() == b.OutlineColor() &&
-             a.InternalVisitedOutlineColor() == b.InternalVisitedOutlineColor();
-    case CSSPropertyID::kOutlineOffset:
-      return a.OutlineOffset() == b.OutlineOffset();
-    case CSSPropertyID::kOutlineWidth:
-      return a.OutlineWidth() == b.OutlineWidth();
-    case CSSPropertyID::kPaddingBottom:
-      return a.PaddingBottom() == b.PaddingBottom();
-    case CSSPropertyID::kPaddingLeft:
-      return a.PaddingLeft() == b.PaddingLeft();
-    case CSSPropertyID::kPaddingRight:
-      return a.PaddingRight() == b.PaddingRight();
-    case CSSPropertyID::kPaddingTop:
-      return a.PaddingTop() == b.PaddingTop();
-    case CSSPropertyID::kRight:
-      return a.Right() == b.Right();
-    case CSSPropertyID::kShapeImageThreshold:
-      return a.ShapeImageThreshold() == b.ShapeImageThreshold();
-    case CSSPropertyID::kShapeMargin:
-      return a.ShapeMargin() == b.ShapeMargin();
-    case CSSPropertyID::kShapeOutside:
-      return DataEquivalent(a.ShapeOutside(), b.ShapeOutside());
-    case CSSPropertyID::kStopColor:
-      return a.StopColor() == b.StopColor();
-    case CSSPropertyID::kStopOpacity:
-      return a.StopOpacity() == b.StopOpacity();
-    case CSSPropertyID::kStroke: {
-      const SVGComputedStyle& a_svg = a.SvgStyle();
-      const SVGComputedStyle& b_svg = b.SvgStyle();
-      return a_svg.StrokePaint().EqualTypeOrColor(b_svg.StrokePaint()) &&
-             a_svg.InternalVisitedStrokePaint().EqualTypeOrColor(
-                 b_svg.InternalVisitedStrokePaint());
-    }
-    case CSSPropertyID::kStrokeDasharray:
-      return a.StrokeDashArray() == b.StrokeDashArray();
-    case CSSPropertyID::kStrokeDashoffset:
-      return a.StrokeDashOffset() == b.StrokeDashOffset();
-    case CSSPropertyID::kStrokeMiterlimit:
-      return a.StrokeMiterLimit() == b.StrokeMiterLimit();
-    case CSSPropertyID::kStrokeOpacity:
-      return a.StrokeOpacity() == b.StrokeOpacity();
-    case CSSPropertyID::kStrokeWidth:
-      return a.StrokeWidth() == b.StrokeWidth();
-    case CSSPropertyID::kTextDecorationColor:
-      return a.TextDecorationColor() == b.TextDecorationColor() &&
-             a.InternalVisitedTextDecorationColor() ==
-                 b.InternalVisitedTextDecorationColor();
-    case CSSPropertyID::kTextDecorationSkipInk:
-      return a.TextDecorationSkipInk() == b.TextDecorationSkipInk();
-    case CSSPropertyID::kTextIndent:
-      return a.TextIndent() == b.TextIndent();
-    case CSSPropertyID::kTextShadow:
-      return DataEquivalent(a.TextShadow(), b.TextShadow());
-    case CSSPropertyID::kTextSizeAdjust:
-      return a.GetTextSizeAdjust() == b.GetTextSizeAdjust();
-    case CSSPropertyID::kTop:
-      return a.Top() == b.Top();
-    case CSSPropertyID::kVerticalAlign:
-      return a.VerticalAlign() == b.VerticalAlign() &&
-             (a.VerticalAlign() != EVerticalAlign::kLength ||
-              a.GetVerticalAlignLength() == b.GetVerticalAlignLength());
-    case CSSPropertyID::kVisibility:
-      return a.Visibility() == b.Visibility();
-    case CSSPropertyID::kWebkitBorderHorizontalSpacing:
-      return a.HorizontalBorderSpacing() == b.HorizontalBorderSpacing();
-    case CSSPropertyID::kWebkitBorderVerticalSpacing:
-      return a.VerticalBorderSpacing() == b.VerticalBorderSpacing();
-    case CSSPropertyID::kClipPath:
-      return DataEquivalent(a.ClipPath(), b.ClipPath());
-    case CSSPropertyID::kColumnCount:
-      return a.ColumnCount() == b.ColumnCount();
-    case CSSPropertyID::kColumnGap:
-      return a.ColumnGap() == b.ColumnGap();
-    case CSSPropertyID::kRowGap:
-      return a.RowGap() == b.RowGap();
-    case CSSPropertyID::kColumnRuleColor:
-      return a.ColumnRuleColor() == b.ColumnRuleColor() &&
-             a.InternalVisitedColumnRuleColor() ==
-                 b.InternalVisitedColumnRuleColor();
-    case CSSPropertyID::kColumnRuleWidth:
-      return a.ColumnRuleWidth() == b.ColumnRuleWidth();
-    case CSSPropertyID::kColumnWidth:
-      return a.ColumnWidth() == b.ColumnWidth();
-    case CSSPropertyID::kFilter:
-      return a.Filter() == b.Filter();
-    case CSSPropertyID::kBackdropFilter:
-      return a.BackdropFilter() == b.BackdropFilter();
-    case CSSPropertyID::kWebkitMaskBoxImageOutset:
-      return a.MaskBoxImageOutset() == b.MaskBoxImageOutset();
-    case CSSPropertyID::kWebkitMaskBoxImageSlice:
-      return a.MaskBoxImageSlices() == b.MaskBoxImageSlices();
-    case CSSPropertyID::kWebkitMaskBoxImageSource:
-      return DataEquivalent(a.MaskBoxImageSource(), b.MaskBoxImageSource());
-    case CSSPropertyID::kWebkitMaskBoxImageWidth:
-      return a.MaskBoxImageWidth() == b.MaskBoxImageWidth();
-    case CSSPropertyID::kWebkitMaskImage:
-      return DataEquivalent(a.MaskImage(), b.MaskImage());
-    case CSSPropertyID::kWebkitMaskPositionX:
-      return FillLayersEqual<CSSPropertyID::kWebkitMaskPositionX>(
-          a.MaskLayers(), b.MaskLayers());
-    case CSSPropertyID::kWebkitMaskPositionY:
-      return FillLayersEqual<CSSPropertyID::kWebkitMaskPositionY>(
-          a.MaskLayers(), b.MaskLayers());
-    case CSSPropertyID::kWebkitMaskSize:
-      return FillLayersEqual<CSSPropertyID::kWebkitMaskSize>(a.MaskLayers(),
-                                                             b.MaskLayers());
-    case CSSPropertyID::kPerspective:
-      return a.Perspective() == b.Perspective();
-    case CSSPropertyID::kPerspectiveOrigin:
-      return a.PerspectiveOriginX() == b.PerspectiveOriginX() &&
-             a.PerspectiveOriginY() == b.PerspectiveOriginY();
-    case CSSPropertyID::kWebkitTextStrokeColor:
-      return a.TextStrokeColor() == b.TextStrokeColor() &&
-             a.InternalVisitedTextStrokeColor() ==
-                 b.InternalVisitedTextStrokeColor();
-    case CSSPropertyID::kTransform:
-      return a.Transform() == b.Transform();
-    case CSSPropertyID::kTranslate:
-      return DataEquivalent<TransformOperation>(a.Translate(), b.Translate());
-    case CSSPropertyID::kRotate:
-      return DataEquivalent<TransformOperation>(a.Rotate(), b.Rotate());
-    case CSSPropertyID::kScale:
-      return DataEquivalent<TransformOperation>(a.Scale(), b.Scale());
-    case CSSPropertyID::kTransformOrigin:
-      return a.TransformOriginX() == b.TransformOriginX() &&
-             a.TransformOriginY() == b.TransformOriginY() &&
-             a.TransformOriginZ() == b.TransformOriginZ();
-    case CSSPropertyID::kWebkitPerspectiveOriginX:
-      return a.PerspectiveOriginX() == b.PerspectiveOriginX();
-    case CSSPropertyID::kWebkitPerspectiveOriginY:
-      return a.PerspectiveOriginY() == b.PerspectiveOriginY();
-    case CSSPropertyID::kWebkitTransformOriginX:
-      return a.TransformOriginX() == b.TransformOriginX();
-    case CSSPropertyID::kWebkitTransformOriginY:
-      return a.TransformOriginY() == b.TransformOriginY();
-    case CSSPropertyID::kWebkitTransformOriginZ:
-      return a.TransformOriginZ() == b.TransformOriginZ();
-    case CSSPropertyID::kWidows:
-      return a.Widows() == b.Widows();
-    case CSSPropertyID::kWidth:
-      return a.Width() == b.Width();
-    case CSSPropertyID::kWordSpacing:
-      return a.WordSpacing() == b.WordSpacing();
-    case CSSPropertyID::kD:
-      return DataEquivalent(a.SvgStyle().D(), b.SvgStyle().D());
-    case CSSPropertyID::kCx:
-      return a.SvgStyle().Cx() == b.SvgStyle().Cx();
-    case CSSPropertyID::kCy:
-      return a.SvgStyle().Cy() == b.SvgStyle().Cy();
-    case CSSPropertyID::kX:
-      return a.SvgStyle().X() == b.SvgStyle().X();
-    case CSSPropertyID::kY:
-      return a.SvgStyle().Y() == b.SvgStyle().Y();
-    case CSSPropertyID::kR:
-      return a.SvgStyle().R() == b.SvgStyle().R();
-    case CSSPropertyID::kRx:
-      return a.SvgStyle().Rx() == b.SvgStyle().Rx();
-    case CSSPropertyID::kRy:
-      return a.SvgStyle().Ry() == b.SvgStyle().Ry();
-    case CSSPropertyID::kZIndex:
-      return a.HasAutoZIndex() == b.HasAutoZIndex() &&
-             (a.HasAutoZIndex() || a.ZIndex() == b.ZIndex());
-    case CSSPropertyID::kContainIntrinsicSize:
-      return a.ContainIntrinsicSize() == b.ContainIntrinsicSize();
-    case CSSPropertyID::kAspectRatio:
-      return a.AspectRatio() == b.AspectRatio();
-    case CSSPropertyID::kMathDepth:
-      return a.MathDepth() == b.MathDepth();
-    default:
-      NOTREACHED();
-      return true;
+  const CSSProperty& css_property = property.GetCSSProperty();
+  PropertyComparator comparator =
+      GetPropertyComparatorTable().FieldComparator(css_property.PropertyID());
+  if (!comparator) {
+    NOTREACHED();
+    return true;
   }
+  return comparator(css_property, a, b);
 }
 
 int CSSPropertyEquality::PropertiesEqualForDOMGuard(const PropertyHandle& property, const ComputedStyle& a, const ComputedStyle& b) {
-  switch (property.GetCSSProperty().PropertyID()) {
-    case CSSPropertyID::kBackgroundColor:
-      return a.BackgroundColor() == b.BackgroundColor() &&
-             a.InternalVisitedBackgroundColor() ==
-                 b.InternalVisitedBackgroundColor();
-    case CSSPropertyID::kBackgroundImage:
-      return FillLayersEqual<CSSPropertyID::kBackgroundImage>(
-          a.BackgroundLayers(), b.BackgroundLayers());
-    case CSSPropertyID::kBackgroundPositionX:
-      return FillLayersEqual<CSSPropertyID::kBackgroundPositionX>(
-          a.BackgroundLayers(), b.BackgroundLayers());
-    case CSSPropertyID::kBackgroundPositionY:
-      return FillLayersEqual<CSSPropertyID::kBackgroundPositionY>(
-          a.BackgroundLayers(), b.BackgroundLayers());
-    case CSSPropertyID::kBackgroundSize:
-      return FillLayersEqual<CSSPropertyID::kBackgroundSize>(
-          a.BackgroundLayers(), b.BackgroundLayers());
-    case CSSPropertyID::kBaselineShift:
-      return a.BaselineShiftValue() == b.BaselineShiftValue();
-    case CSSPropertyID::kBorderBottomColor:
-      return a.BorderBottomColor() == b.BorderBottomColor() &&
-             a.InternalVisitedBorderBottomColor() ==
-                 b.InternalVisitedBorderBottomColor();
-    case CSSPropertyID::kBorderBottomLeftRadius:
-      return a.BorderBottomLeftRadius() == b.BorderBottomLeftRadius();
-    case CSSPropertyID::kBorderBottomRightRadius:
-      return a.BorderBottomRightRadius() == b.BorderBottomRightRadius();
-    case CSSPropertyID::kBorderBottomWidth:
-      return a.BorderBottomWidth() == b.BorderBottomWidth();
-    case CSSPropertyID::kBorderImageOutset:
-      return a.BorderImageOutset() == b.BorderImageOutset();
-    case CSSPropertyID::kBorderImageSlice:
-      return a.BorderImageSlices() == b.BorderImageSlices();
-    case CSSPropertyID::kBorderImageSource:
-      return DataEquivalent(a.BorderImageSource(), b.BorderImageSource());
-    case CSSPropertyID::kBorderImageWidth:
-      return a.BorderImageWidth() == b.BorderImageWidth();
-    case CSSPropertyID::kBorderLeftColor:
-      return a.BorderLeftColor() == b.BorderLeftColor() &&
-             a.InternalVisitedBorderLeftColor() ==
-                 b.InternalVisitedBorderLeftColor();
-    case CSSPropertyID::kBorderLeftWidth:
-      return a.BorderLeftWidth() == b.BorderLeftWidth();
-    case CSSPropertyID::kBorderRightColor:
-      return a.BorderRightColor() == b.BorderRightColor() &&
-             a.InternalVisitedBorderRightColor() ==
-                 b.InternalVisitedBorderRightColor();
-    case CSSPropertyID::kBorderRightWidth:
-      return a.BorderRightWidth() == b.BorderRightWidth();
-    case CSSPropertyID::kBorderTopColor:
-      return a.BorderTopColor() == b.BorderTopColor() &&
-             a.InternalVisitedBorderTopColor() ==
-                 b.InternalVisitedBorderTopColor();
-    case CSSPropertyID::kBorderTopLeftRadius:
-      return a.BorderTopLeftRadius() == b.BorderTopLeftRadius();
-    case CSSPropertyID::kBorderTopRightRadius:
-      return a.BorderTopRightRadius() == b.BorderTopRightRadius();
-    case CSSPropertyID::kBorderTopWidth:
-      return a.BorderTopWidth() == b.BorderTopWidth();
-    case CSSPropertyID::kBottom:
-      return a.Bottom() == b.Bottom();
-    case CSSPropertyID::kBoxShadow:
-      return DataEquivalent(a.BoxShadow(), b.BoxShadow());
-    case CSSPropertyID::kCaretColor:
-      return a.CaretColor() == b.CaretColor() &&
-             a.InternalVisitedCaretColor() == b.InternalVisitedCaretColor();
-    case CSSPropertyID::kClip:
-      return a.Clip() == b.Clip();
-    case CSSPropertyID::kColor:
-      return a.GetColor() == b.GetColor() &&
-             a.InternalVisitedColor() == b.InternalVisitedColor();
-    case CSSPropertyID::kFill: {
-      const SVGComputedStyle& a_svg = a.SvgStyle();
-      const SVGComputedStyle& b_svg = b.SvgStyle();
-      return a_svg.FillPaint().EqualTypeOrColor(b_svg.FillPaint()) &&
-             a_svg.InternalVisitedFillPaint().EqualTypeOrColor(
-                 b_svg.InternalVisitedFillPaint());
-    }
-    case CSSPropertyID::kFillOpacity:
-      return a.FillOpacity() == b.FillOpacity();
-    case CSSPropertyID::kFlexBasis:
-      return a.FlexBasis() == b.FlexBasis();
-    case CSSPropertyID::kFlexGrow:
-      return a.FlexGrow() == b.FlexGrow();
-    case CSSPropertyID::kFlexShrink:
-      return a.FlexShrink() == b.FlexShrink();
-    case CSSPropertyID::kFloodColor:
-      return a.FloodColor() == b.FloodColor();
-    case CSSPropertyID::kFloodOpacity:
-      return a.FloodOpacity() == b.FloodOpacity();
-    case CSSPropertyID::kFontSize:
-      // CSSPropertyID::kFontSize: Must pass a specified size to setFontSize if
-      // Text Autosizing is enabled, but a computed size if text zoom is enabled
-      // (if neither is enabled it's irrelevant as they're probably the same).
-      // FIXME: Should we introduce an option to pass the computed font size
-      // here, allowing consumers to enable text zoom rather than Text
-      // Autosizing? See http://crbug.com/227545.
-      return a.SpecifiedFontSize() == b.SpecifiedFontSize();
-    case CSSPropertyID::kFontSizeAdjust:
-      return a.FontSizeAdjust() == b.FontSizeAdjust();
-    case CSSPropertyID::kFontStretch:
-      return a.GetFontStretch() == b.GetFontStretch();
-    case CSSPropertyID::kFontVariationSettings:
-      return DataEquivalent(a.GetFontDescription().VariationSettings(),
-                            b.GetFontDescription().VariationSettings());
-    case CSSPropertyID::kFontWeight:
-      return a.GetFontWeight() == b.GetFontWeight();
-    case CSSPropertyID::kHeight:
-      return a.Height() == b.Height();
-    case CSSPropertyID::kLeft:
-      return a.Left() == b.Left();
-    case CSSPropertyID::kLetterSpacing:
-      return a.LetterSpacing() == b.LetterSpacing();
-    case CSSPropertyID::kLightingColor:
-      return a.LightingColor() == b.LightingColor();
-    case CSSPropertyID::kLineHeight:
-      return a.SpecifiedLineHeight() == b.SpecifiedLineHeight();
-    case CSSPropertyID::kTabSize:
-      return a.GetTabSize() == b.GetTabSize();
-    case CSSPropertyID::kListStyleImage:
-      return DataEquivalent(a.ListStyleImage(), b.ListStyleImage());
-    case CSSPropertyID::kMarginBottom:
-      return a.MarginBottom() == b.MarginBottom();
-    case CSSPropertyID::kMarginLeft:
-      return a.MarginLeft() == b.MarginLeft();
-    case CSSPropertyID::kMarginRight:
-      return a.MarginRight() == b.MarginRight();
-    case CSSPropertyID::kMarginTop:
-      return a.MarginTop() == b.MarginTop();
-    case CSSPropertyID::kMaxHeight:
-      return a.MaxHeight() == b.MaxHeight();
-    case CSSPropertyID::kMaxWidth:
-      return a.MaxWidth() == b.MaxWidth();
-    case CSSPropertyID::kMinHeight:
-      return a.MinHeight() == b.MinHeight();
-    case CSSPropertyID::kMinWidth:
-      return a.MinWidth() == b.MinWidth();
-    case CSSPropertyID::kObjectPosition:
-      return a.ObjectPosition() == b.ObjectPosition();
-    case CSSPropertyID::kOffsetAnchor:
-      return a.OffsetAnchor() == b.OffsetAnchor();
-    case CSSPropertyID::kOffsetDistance:
-      return a.OffsetDistance() == b.OffsetDistance();
-    case CSSPropertyID::kOffsetPath:
-      return DataEquivalent(a.OffsetPath(), b.OffsetPath());
-    case CSSPropertyID::kOffsetPosition:
-      return a.OffsetPosition() == b.OffsetPosition();
-    case CSSPropertyID::kOffsetRotate:
-      return a.OffsetRotate() == b.OffsetRotate();
-    case CSSPropertyID::kOpacity:
-      return a.Opacity() == b.Opacity();
-    case CSSPropertyID::kOrder:
-      return a.Order() == b.Order();
-    case CSSPropertyID::kOrphans:
-      return a.Orphans() == b.Orphans();
-    case CSSPropertyID::kOutlineColor:
-      return a.OutlineColor() == b.OutlineColor() &&
-             a.InternalVisitedOutlineColor() == b.InternalVisitedOutlineColor();
-    case CSSPropertyID::kOutlineOffset:
-      return a.OutlineOffset() == b.OutlineOffset();
-    case CSSPropertyID::kOutlineWidth:
-      return a.OutlineWidth() == b.OutlineWidth();
-    case CSSPropertyID::kPaddingBottom:
-      return a.PaddingBottom() == b.PaddingBottom();
-    case CSSPropertyID::kPaddingLeft:
-      return a.PaddingLeft() == b.PaddingLeft();
-    case CSSPropertyID::kPaddingRight:
-      return a.PaddingRight() == b.PaddingRight();
-    case CSSPropertyID::kPaddingTop:
-      return a.PaddingTop() == b.PaddingTop();
-    case CSSPropertyID::kRight:
-      return a.Right() == b.Right();
-    case CSSPropertyID::kShapeImageThreshold:
-      return a.ShapeImageThreshold() == b.ShapeImageThreshold();
-    case CSSPropertyID::kShapeMargin:
-      return a.ShapeMargin() == b.ShapeMargin();
-    case CSSPropertyID::kShapeOutside:
-      return DataEquivalent(a.ShapeOutside(), b.ShapeOutside());
-    case CSSPropertyID::kStopColor:
-      return a.StopColor() == b.StopColor();
-    case CSSPropertyID::kStopOpacity:
-      return a.StopOpacity() == b.StopOpacity();
-    case CSSPropertyID::kStroke: {
-      const SVGComputedStyle& a_svg = a.SvgStyle();
-      const SVGComputedStyle& b_svg = b.SvgStyle();
-      return a_svg.StrokePaint().EqualTypeOrColor(b_svg.StrokePaint()) &&
-             a_svg.InternalVisitedStrokePaint().EqualTypeOrColor(
-                 b_svg.InternalVisitedStrokePaint());
-    }
-    case CSSPropertyID::kStrokeDasharray:
-      return a.StrokeDashArray() == b.StrokeDashArray();
-    case CSSPropertyID::kStrokeDashoffset:
-      return a.StrokeDashOffset() == b.StrokeDashOffset();
-    case CSSPropertyID::kStrokeMiterlimit:
-      return a.StrokeMiterLimit() == b.StrokeMiterLimit();
-    case CSSPropertyID::kStrokeOpacity:
-      return a.StrokeOpacity() == b.StrokeOpacity();
-    case CSSPropertyID::kStrokeWidth:
-      return a.StrokeWidth() == b.StrokeWidth();
-    case CSSPropertyID::kTextDecorationColor:
-      return a.TextDecorationColor() == b.TextDecorationColor() &&
-             a.InternalVisitedTextDecorationColor() ==
-                 b.InternalVisitedTextDecorationColor();
-    case CSSPropertyID::kTextDecorationSkipInk:
-      return a.TextDecorationSkipInk() == b.TextDecorationSkipInk();
-    case CSSPropertyID::kTextIndent:
-      return a.TextIndent() == b.TextIndent();
-    case CSSPropertyID::kTextShadow:
-      return DataEquivalent(a.TextShadow(), b.TextShadow());
-    case CSSPropertyID::kTextSizeAdjust:
-      return a.GetTextSizeAdjust() == b.GetTextSizeAdjust();
-    case CSSPropertyID::kTop:
-      return a.Top() == b.Top();
-    case CSSPropertyID::kVerticalAlign:
-      return a.VerticalAlign() == b.VerticalAlign() &&
-             (a.VerticalAlign() != EVerticalAlign::kLength ||
-              a.GetVerticalAlignLength() == b.GetVerticalAlignLength());
-    case CSSPropertyID::kVisibility:
-      return a.Visibility() == b.Visibility();
-    case CSSPropertyID::kWebkitBorderHorizontalSpacing:
-      return a.HorizontalBorderSpacing() == b.HorizontalBorderSpacing();
-    case CSSPropertyID::kWebkitBorderVerticalSpacing:
-      return a.VerticalBorderSpacing() == b.VerticalBorderSpacing();
-    case CSSPropertyID::kClipPath:
-      return DataEquivalent(a.ClipPath(), b.ClipPath());
-    case CSSPropertyID::kColumnCount:
-      return a.ColumnCount() == b.ColumnCount();
-    case CSSPropertyID::kColumnGap:
-      return a.ColumnGap() == b.ColumnGap();
-    case CSSPropertyID::kRowGap:
-      return a.RowGap() == b.RowGap();
-    case CSSPropertyID::kColumnRuleColor:
-      return a.ColumnRuleColor() == b.ColumnRuleColor() &&
-             a.InternalVisitedColumnRuleColor() ==
-                 b.InternalVisitedColumnRuleColor();
-    case CSSPropertyID::kColumnRuleWidth:
-      return a.ColumnRuleWidth() == b.ColumnRuleWidth();
-    case CSSPropertyID::kColumnWidth:
-      return a.ColumnWidth() == b.ColumnWidth();
-    case CSSPropertyID::kFilter:
-      return a.Filter() == b.Filter();
-    case CSSPropertyID::kBackdropFilter:
-      return a.BackdropFilter() == b.BackdropFilter();
-    case CSSPropertyID::kWebkitMaskBoxImageOutset:
-      return a.MaskBoxImageOutset() == b.MaskBoxImageOutset();
-    case CSSPropertyID::kWebkitMaskBoxImageSlice:
-      return a.MaskBoxImageSlices() == b.MaskBoxImageSlices();
-    case CSSPropertyID::kWebkitMaskBoxImageSource:
-      return DataEquivalent(a.MaskBoxImageSource(), b.MaskBoxImageSource());
-    case CSSPropertyID::kWebkitMaskBoxImageWidth:
-      return a.MaskBoxImageWidth() == b.MaskBoxImageWidth();
-    case CSSPropertyID::kWebkitMaskImage:
-      return DataEquivalent(a.MaskImage(), b.MaskImage());
-    case CSSPropertyID::kWebkitMaskPositionX:
-      return FillLayersEqual<CSSPropertyID::kWebkitMaskPositionX>(
-          a.MaskLayers(), b.MaskLayers());
-    case CSSPropertyID::kWebkitMaskPositionY:
-      return FillLayersEqual<CSSPropertyID::kWebkitMaskPositionY>(
-          a.MaskLayers(), b.MaskLayers());
-    case CSSPropertyID::kWebkitMaskSize:
-      return FillLayersEqual<CSSPropertyID::kWebkitMaskSize>(a.MaskLayers(),
-                                                             b.MaskLayers());
-    case CSSPropertyID::kPerspective:
-      return a.Perspective() == b.Perspective();
-    case CSSPropertyID::kPerspectiveOrigin:
-      return a.PerspectiveOriginX() == b.PerspectiveOriginX() &&
-             a.PerspectiveOriginY() == b.PerspectiveOriginY();
-    case CSSPropertyID::kWebkitTextStrokeColor:
-      return a.TextStrokeColor() == b.TextStrokeColor() &&
-             a.InternalVisitedTextStrokeColor() ==
-                 b.InternalVisitedTextStrokeColor();
-    case CSSPropertyID::kTransform:
-      return a.Transform() == b.Transform();
-    case CSSPropertyID::kTranslate:
-      return DataEquivalent<TransformOperation>(a.Translate(), b.Translate());
-    case CSSPropertyID::kRotate:
-      return DataEquivalent<TransformOperation>(a.Rotate(), b.Rotate());
-    case CSSPropertyID::kScale:
-      return DataEquivalent<TransformOperation>(a.Scale(), b.Scale());
-    case CSSPropertyID::kTransformOrigin:
-      return a.TransformOriginX() == b.TransformOriginX() &&
-             a.TransformOriginY() == b.TransformOriginY() &&
-             a.TransformOriginZ() == b.TransformOriginZ();
-    case CSSPropertyID::kWebkitPerspectiveOriginX:
-      return a.PerspectiveOriginX() == b.PerspectiveOriginX();
-    case CSSPropertyID::kWebkitPerspectiveOriginY:
-      return a.PerspectiveOriginY() == b.PerspectiveOriginY();
-    case CSSPropertyID::kWebkitTransformOriginX:
-      return a.TransformOriginX() == b.TransformOriginX();
-    case CSSPropertyID::kWebkitTransformOriginY:
-      return a.TransformOriginY() == b.TransformOriginY();
-    case CSSPropertyID::kWebkitTransformOriginZ:
-      return a.TransformOriginZ() == b.TransformOriginZ();
-    case CSSPropertyID::kWidows:
-      return a.Widows() == b.Widows();
-    case CSSPropertyID::kWidth:
-      return a.Width() == b.Width();
-    case CSSPropertyID::kWordSpacing:
-      return a.WordSpacing() == b.WordSpacing();
-    case CSSPropertyID::kD:
-      return DataEquivalent(a.SvgStyle().D(), b.SvgStyle().D());
-    case CSSPropertyID::kCx:
-      return a.SvgStyle().Cx() == b.SvgStyle().Cx();
-    case CSSPropertyID::kCy:
-      return a.SvgStyle().Cy() == b.SvgStyle().Cy();
-    case CSSPropertyID::kX:
-      return a.SvgStyle().X() == b.SvgStyle().X();
-    case CSSPropertyID::kY:
-      return a.SvgStyle().Y() == b.SvgStyle().Y();
-    case CSSPropertyID::kR:
-      return a.SvgStyle().R() == b.SvgStyle().R();
-    case CSSPropertyID::kRx:
-      return a.SvgStyle().Rx() == b.SvgStyle().Rx();
-    case CSSPropertyID::kRy:
-      return a.SvgStyle().Ry() == b.SvgStyle().Ry();
-    case CSSPropertyID::kZIndex:
-      return a.HasAutoZIndex() == b.HasAutoZIndex() &&
-             (a.HasAutoZIndex() || a.ZIndex() == b.ZIndex());
-    case CSSPropertyID::kContainIntrinsicSize:
-      return a.ContainIntrinsicSize() == b.ContainIntrinsicSize();
-    case CSSPropertyID::kAspectRatio:
-      return a.AspectRatio() == b.AspectRatio();
-    case CSSPropertyID::kMathDepth:
-      return a.MathDepth() == b.MathDepth();
-    default:
-      if (property.GetCSSProperty().IsComputedValueComparable()) {
-        return property.GetCSSProperty().ComputedValuesEqual(a, b);
-      } else {
-        return -1;
-      }
+  const CSSProperty& css_property = property.GetCSSProperty();
+  PropertyComparator comparator = GetPropertyComparatorTable().DOMGuardComparator(css_property.PropertyID());
+  if (!comparator) {
+    return -1;
   }
+  return comparator(css_property, a, b);
 }
 }  // namespace blink
@@ -22,6 +22,9 @@ class CSSPropertyEquality {
                               const ComputedStyle&,
                               const ComputedStyle&);
 
+  // Returns 1 if the two styles have the same computed value for |property|,
+  // 0 if they do not, and -1 if the property has no field comparator and the
+  // caller has to compare the serialized computed values instead.
   static int PropertiesEqualForDOMGuard(const PropertyHandle&, const ComputedStyle&, const ComputedStyle&);
 };
 
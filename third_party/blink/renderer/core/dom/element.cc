@@ -85,6 +85,7 @@
 #include "third_party/blink/renderer/core/dom/mutation_record.h"
 #include "third_party/blink/renderer/core/dom/named_node_map.h"
 #include "third_party/blink/renderer/core/dom/node_computed_style.h"
+#include "third_party/blink/renderer/core/dom/pending_attribute_changes.h"
 #include "third_party/blink/renderer/core/dom/presentation_attribute_style.h"
 #include "third_party/blink/renderer/core/dom/pseudo_element.h"
 #include "third_party/blink/renderer/core/dom/scriptable_document_parser.h"
@@ -2495,8 +2496,7 @@ void Element::ParserSetAttributes(const Vector<Attribute>& attribute_vector, boo
         attribute.GetName(), g_null_atom, attribute.Value(),
         AttributeModificationReason::kByParser));
     } else {
-      EnsureUniqueElementData().pending_attribute_modifications_.push_back(
-        UniqueElementData::AttributeModificationParams(attribute.GetName(), g_null_atom, attribute.Value(), 1));
+      AddPendingAttributeChange(attribute.GetName(), g_null_atom, attribute.Value(), AttributeModificationReason::kByParser);
     }
   }
 }
@@ -5639,8 +5639,7 @@ void Element::DidAddAttribute(const QualifiedName& name,
     AttributeChanged(AttributeModificationParams(
       name, g_null_atom, value, AttributeModificationReason::kDirectly));
   } else {
-    EnsureUniqueElementData().pending_attribute_modifications_.push_back(
-      UniqueElementData::AttributeModificationParams(name, g_null_atom, value, 0));    
+    AddPendingAttributeChange(name, g_null_atom, value, AttributeModificationReason::kDirectly);
   }
   probe::DidModifyDOMAttr(this, name, value);
   DispatchSubtreeModifiedEvent();
@@ -5666,8 +5665,7 @@ void Element::DidModifyAttribute(const QualifiedName& name,
     AttributeChanged(AttributeModificationParams(
       name, old_value, new_value, AttributeModificationReason::kDirectly));
   } else {
-    EnsureUniqueElementData().pending_attribute_modifications_.push_back(
-      UniqueElementData::AttributeModificationParams(name, old_value, new_value, 0));    
+    AddPendingAttributeChange(name, old_value, new_value, AttributeModificationReason::kDirectly);
   }
   probe::DidModifyDOMAttr(this, name, new_value);
   // Do not dispatch a DOMSubtreeModified event here; see bug 81141.
@@ -5692,8 +5690,7 @@ void Element::DidRemoveAttribute(const QualifiedName& name,
     AttributeChanged(AttributeModificationParams(
       name, old_value, g_null_atom, AttributeModificationReason::kDirectly));
   } else {
-    EnsureUniqueElementData().pending_attribute_modifications_.push_back(
-      UniqueElementData::AttributeModificationParams(name, old_value, g_null_atom, 0));     
+    AddPendingAttributeChange(name, old_value, g_null_atom, AttributeModificationReason::kDirectly);
   }
   probe::DidRemoveDOMAttr(this, name);
   DispatchSubtreeModifiedEvent();
@@ -5728,6 +5725,11 @@ static void ReResolveURLsInInlineStyle(const Document& document,
 void Element::DidMoveToNewDocument(Document& old_document) {
   Node::DidMoveToNewDocument(old_document);
 
+  if (HasPendingAttributeChanges()) {
+    PendingAttributeChanges::From(GetDocument())
+        .Adopt(*this, PendingAttributeChanges::From(old_document));
+  }
+
   // If the documents differ by quirks mode then they differ by case sensitivity
   // for class and id names so we need to go through the attribute change logic
   // to pick up the new casing in the ElementData.
@@ -5935,8 +5937,7 @@ void Element::CloneAttributesFrom(const Element& other) {
         attr.GetName(), g_null_atom, attr.Value(),
         AttributeModificationReason::kByCloning));
     } else {
-      EnsureUniqueElementData().pending_attribute_modifications_.push_back(
-        UniqueElementData::AttributeModificationParams(attr.GetName(), g_null_atom, attr.Value(), 2));
+      AddPendingAttributeChange(attr.GetName(), g_null_atom, attr.Value(), AttributeModificationReason::kByCloning);
     }
   }
 
@@ -6009,18 +6010,21 @@ void Element::NotifyInlineStyleMutation() {
   }
 }
 
+void Element::AddPendingAttributeChange(const QualifiedName& name, const AtomicString& old_value, const AtomicString& new_value, AttributeModificationReason reason) {
+  if (PendingAttributeChanges::From(GetDocument()).Add(*this, name, old_value, new_value, reason))
+    SetHasPendingAttributeChanges();
+  else
+    ClearHasPendingAttributeChanges();
+}
+
 void Element::ExecutePendingAttributeChanges() {
-  if (GetElementData() && GetElementData()->IsUnique() && EnsureUniqueElementData().pending_attribute_modifications_.size()) {
-    for (const auto& params : EnsureUniqueElementData().pending_attribute_modifications_) {
-      AttributeChanged(AttributeModificationParams(
-        params.name, params.old_value, params.new_value,
-        params.reason == 0 ? 
-          AttributeModificationReason::kDirectly : 
-          (params.reason == 1 ? 
-            AttributeModificationReason::kByParser :
-            AttributeModificationReason::kByCloning)));
-    }
-    EnsureUniqueElementData().pending_attribute_modifications_.clear();
+  if (!HasPendingAttributeChanges())
+    return;
+  ClearHasPendingAttributeChanges();
+  // AttributeChanged() may hold back further changes, which wait for the next flush.
+  for (const auto& change : PendingAttributeChanges::From(GetDocument()).Take(*this)) {
+    AttributeChanged(AttributeModificationParams(
+      change.name, change.old_value, change.new_value, change.reason));
   }
 }
 
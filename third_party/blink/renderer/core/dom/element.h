@@ -1099,6 +1099,7 @@ class CORE_EXPORT Element : public ContainerNode, public Animatable {
                           const AtomicString& new_value,
                           bool delay_attribute_changed = true);
   void DidRemoveAttribute(const QualifiedName&, const AtomicString& old_value, bool delay_attribute_changed = true);
+  void AddPendingAttributeChange(const QualifiedName&, const AtomicString& old_value, const AtomicString& new_value, AttributeModificationReason);
 
   void SynchronizeAllAttributes() const;
   void SynchronizeAttribute(const QualifiedName&) const;
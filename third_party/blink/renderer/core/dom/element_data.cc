@@ -158,8 +158,7 @@ UniqueElementData::UniqueElementData() = default;
 UniqueElementData::UniqueElementData(const UniqueElementData& other)
     : ElementData(other, true),
       presentation_attribute_style_(other.presentation_attribute_style_),
-      attribute_vector_(other.attribute_vector_),
-      pending_attribute_modifications_(other.pending_attribute_modifications_) {
+      attribute_vector_(other.attribute_vector_) {
   inline_style_ =
       other.inline_style_ ? other.inline_style_->MutableCopy() : nullptr;
 }
@@ -199,30 +199,12 @@ class UniqueElementData final : public ElementData {
 
   void TraceAfterDispatch(blink::Visitor*) const;
 
-  struct AttributeModificationParams {
-    public:
-      AttributeModificationParams(const QualifiedName& qname,
-                                  const AtomicString& old_value,
-                                  const AtomicString& new_value,
-                                  int reason)
-          : name(qname),
-            old_value(old_value),
-            new_value(new_value),
-            reason(reason) {}
-
-      QualifiedName name;
-      AtomicString old_value;
-      AtomicString new_value;
-      int reason;
-  };
-
   // FIXME: We might want to support sharing element data for elements with
   // presentation attribute style. Lots of table cells likely have the same
   // attributes. Most modern pages don't use presentation attributes though
   // so this might not make sense.
   mutable Member<CSSPropertyValueSet> presentation_attribute_style_;
   AttributeVector attribute_vector_;
-  Vector<AttributeModificationParams> pending_attribute_modifications_;
 };
 
 template <>
@@ -2214,6 +2214,34 @@ void Node::InvalidateIfHasEffectiveAppearance() const {
   layout_object->SetSubtreeShouldDoFullPaintInvalidation();
 }
 
+// Insertion and removal notify a subtree parent first, and a shadow root right
+// after its host, so the parent or host already carries the updated flag.
+bool Node::IsUserAgentShadowTreeRootOrDescendant() const {
+  if (Node* parent = ParentOrShadowHostNode()) {
+    if (parent->IsInUserAgentShadowTree())
+      return true;
+  }
+  auto* shadow_root = DynamicTo<ShadowRoot>(this);
+  return shadow_root && shadow_root->IsUserAgent();
+}
+
+void Node::SetHasPendingAttributeChanges() {
+  if (HasPendingAttributeChanges())
+    return;
+  SetFlag(kHasPendingAttributeChangesFlag);
+  MarkAncestorsWithChildHasPendingAttributeChanges();
+}
+
+// Unlike the style flags, these are not cleared on removal: a stale flag only
+// costs a flush one more visit.
+void Node::MarkAncestorsWithChildHasPendingAttributeChanges() {
+  for (Node* ancestor = ParentOrShadowHostNode();
+       ancestor && !ancestor->ChildHasPendingAttributeChanges();
+       ancestor = ancestor->ParentOrShadowHostNode()) {
+    ancestor->SetFlag(kChildHasPendingAttributeChangesFlag);
+  }
+}
+
 Node::InsertionNotificationRequest Node::InsertedInto(
     ContainerNode& insertion_point) {
   DCHECK(!ChildNeedsStyleInvalidation());
@@ -2226,6 +2254,12 @@ Node::InsertionNotificationRequest Node::InsertedInto(
   }
   if (ParentOrShadowHostNode()->IsInShadowTree())
     SetFlag(kIsInShadowTreeFlag);
+  SetFlag(IsUserAgentShadowTreeRootOrDescendant(),
+          kIsInUserAgentShadowTreeFlag);
+  // A subtree can get pending attribute changes while it is detached, so its
+  // new ancestors have to learn about them.
+  if (HasPendingAttributeChanges() || ChildHasPendingAttributeChanges())
+    MarkAncestorsWithChildHasPendingAttributeChanges();
   if (AXObjectCache* cache = GetDocument().ExistingAXObjectCache())
     cache->ChildrenChanged(&insertion_point);
   return kInsertionDone;
@@ -2244,6 +2278,10 @@ void Node::RemovedFrom(ContainerNode& insertion_point) {
   }
   if (IsInShadowTree() && !ContainingTreeScope().RootNode().IsShadowRoot())
     ClearFlag(kIsInShadowTreeFlag);
+  if (IsInUserAgentShadowTree()) {
+    SetFlag(IsUserAgentShadowTreeRootOrDescendant(),
+            kIsInUserAgentShadowTreeFlag);
+  }
   if (AXObjectCache* cache = GetDocument().ExistingAXObjectCache()) {
     cache->Remove(this);
     cache->ChildrenChanged(&insertion_point);
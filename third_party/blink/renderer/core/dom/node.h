@@ -605,6 +605,12 @@ class CORE_EXPORT Node : public EventTarget {
 
   bool IsInDocumentTree() const { return isConnected() && !IsInShadowTree(); }
   bool IsInShadowTree() const { return GetFlag(kIsInShadowTreeFlag); }
+  // Returns true if this node is a user agent shadow root or has one among its
+  // ancestors, following shadow hosts. Unlike IsInUserAgentShadowRoot(), this
+  // also holds inside author shadow roots nested in a user agent shadow tree.
+  bool IsInUserAgentShadowTree() const {
+    return GetFlag(kIsInUserAgentShadowTreeFlag);
+  }
   bool IsInTreeScope() const {
     return GetFlag(
         static_cast<NodeFlags>(kIsConnectedFlag | kIsInShadowTreeFlag));
@@ -876,6 +882,27 @@ class CORE_EXPORT Node : public EventTarget {
     return GetFlag(kHasDuplicateAttributes);
   }
 
+  // True if this element holds back attribute changes until it is inserted;
+  // see Element::ExecutePendingAttributeChanges().
+  bool HasPendingAttributeChanges() const {
+    return GetFlag(kHasPendingAttributeChangesFlag);
+  }
+  // Sets the flag for the current node and also calls
+  // MarkAncestorsWithChildHasPendingAttributeChanges
+  void SetHasPendingAttributeChanges();
+  void ClearHasPendingAttributeChanges() {
+    ClearFlag(kHasPendingAttributeChangesFlag);
+  }
+  // True if a flush of the pending attribute changes should traverse this
+  // node's children and author shadow root.
+  bool ChildHasPendingAttributeChanges() const {
+    return GetFlag(kChildHasPendingAttributeChangesFlag);
+  }
+  void ClearChildHasPendingAttributeChanges() {
+    ClearFlag(kChildHasPendingAttributeChangesFlag);
+  }
+  void MarkAncestorsWithChildHasPendingAttributeChanges();
+
   bool IsEffectiveRootScroller() const;
 
   virtual LayoutBox* AutoscrollBox();
@@ -938,9 +965,15 @@ class CORE_EXPORT Node : public EventTarget {
 
     kHasDisplayLockContext = 1 << 26,
 
+    // Tree state flag, like kIsInShadowTreeFlag.
+    kIsInUserAgentShadowTreeFlag = 1 << 27,
+
+    kHasPendingAttributeChangesFlag = 1 << 28,
+    kChildHasPendingAttributeChangesFlag = 1 << 29,
+
     kDefaultNodeFlags = kIsFinishedParsingChildrenFlag,
 
-    // 6 bits remaining.
+    // 3 bits remaining.
   };
 
   ALWAYS_INLINE bool GetFlag(NodeFlags mask) const {
@@ -1067,6 +1100,8 @@ class CORE_EXPORT Node : public EventTarget {
 
   void TrackForDebugging();
 
+  bool IsUserAgentShadowTreeRootOrDescendant() const;
+
   NodeRareData& CreateRareData();
 
   const HeapVector<Member<MutationObserverRegistration>>*
@@ -0,0 +1,65 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "third_party/blink/renderer/core/dom/pending_attribute_changes.h"
+
+#include <utility>
+
+namespace blink {
+
+const char PendingAttributeChanges::kSupplementName[] = "PendingAttributeChanges";
+
+PendingAttributeChanges& PendingAttributeChanges::From(Document& document) {
+  PendingAttributeChanges *changes = Supplement<Document>::From<PendingAttributeChanges>(document);
+  if (!changes) {
+    changes = MakeGarbageCollected<PendingAttributeChanges>(document);
+    ProvideTo(document, changes);
+  }
+  return *changes;
+}
+
+PendingAttributeChanges::PendingAttributeChanges(Document& document) : Supplement<Document>(document) {}
+
+bool PendingAttributeChanges::Add(Element& element, const QualifiedName& name, const AtomicString& old_value, const AtomicString& new_value, Element::AttributeModificationReason reason) {
+  Vector<Change>& changes = changes_.insert(&element, Vector<Change>()).stored_value->value;
+  for (wtf_size_t i = 0; i < changes.size(); ++i) {
+    Change& change = changes[i];
+    if (change.name != name) {
+      continue;
+    }
+    if (change.old_value != new_value) {
+      change.new_value = new_value;
+      change.reason = reason;
+      return true;
+    }
+    // Set then removed, or written back: there is nothing left to replay.
+    changes.EraseAt(i);
+    if (changes.IsEmpty()) {
+      changes_.erase(&element);
+      return false;
+    }
+    return true;
+  }
+  changes.push_back(Change{name, old_value, new_value, reason});
+  return true;
+}
+
+Vector<PendingAttributeChanges::Change> PendingAttributeChanges::Take(Element& element) {
+  return changes_.Take(&element);
+}
+
+void PendingAttributeChanges::Adopt(Element& element, PendingAttributeChanges& old_changes) {
+  Vector<Change> changes = old_changes.Take(element);
+  if (changes.IsEmpty()) {
+    return;
+  }
+  changes_.Set(&element, std::move(changes));
+}
+
+void PendingAttributeChanges::Trace(Visitor* visitor) const {
+  visitor->Trace(changes_);
+  Supplement<Document>::Trace(visitor);
+}
+
+}  // namespace blink
@@ -0,0 +1,62 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef THIRD_PARTY_BLINK_RENDERER_CORE_DOM_PENDING_ATTRIBUTE_CHANGES_H_
+#define THIRD_PARTY_BLINK_RENDERER_CORE_DOM_PENDING_ATTRIBUTE_CHANGES_H_
+
+#include "third_party/blink/renderer/core/core_export.h"
+#include "third_party/blink/renderer/core/dom/document.h"
+#include "third_party/blink/renderer/core/dom/element.h"
+#include "third_party/blink/renderer/core/dom/qualified_name.h"
+#include "third_party/blink/renderer/platform/heap/handle.h"
+#include "third_party/blink/renderer/platform/supplementable.h"
+#include "third_party/blink/renderer/platform/wtf/text/atomic_string.h"
+#include "third_party/blink/renderer/platform/wtf/vector.h"
+
+namespace blink {
+
+// The attribute changes that elements of a document hold back until they are
+// inserted, so that DOMGuard sees the insertion before any of them takes
+// effect. Keeping them in this side table rather than in UniqueElementData
+// lets the elements keep shared attribute storage, and only costs memory for
+// elements that actually hold changes back. Node::HasPendingAttributeChanges()
+// tells which elements have an entry, so the others are never looked up.
+class CORE_EXPORT PendingAttributeChanges final
+    : public GarbageCollected<PendingAttributeChanges>,
+      public Supplement<Document> {
+ public:
+  static const char kSupplementName[];
+
+  struct Change {
+    QualifiedName name;
+    AtomicString old_value;
+    AtomicString new_value;
+    Element::AttributeModificationReason reason;
+  };
+
+  static PendingAttributeChanges& From(Document&);
+
+  explicit PendingAttributeChanges(Document&);
+
+  // A change of an attribute that already has one queued is coalesced into it:
+  // the queued change keeps its old value and takes the new value and reason,
+  // and is dropped if that leaves the attribute as it was. Returns whether
+  // |element| still has changes queued.
+  bool Add(Element&, const QualifiedName&, const AtomicString& old_value, const AtomicString& new_value, Element::AttributeModificationReason);
+  // Removes the changes queued for |element| and returns them in the order
+  // their attributes were first changed.
+  Vector<Change> Take(Element&);
+  // Moves the changes queued for |element| in |old_changes| here, for an
+  // element that was adopted from another document.
+  void Adopt(Element&, PendingAttributeChanges& old_changes);
+
+  void Trace(Visitor*) const override;
+
+ private:
+  HeapHashMap<WeakMember<Element>, Vector<Change>> changes_;
+};
+
+}  // namespace blink
+
+#endif  // THIRD_PARTY_BLINK_RENDERER_CORE_DOM_PENDING_ATTRIBUTE_CHANGES_H_
@@ -0,0 +1,48 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "third_party/blink/renderer/core/dom/pending_attribute_changes.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/blink/renderer/core/html/html_element.h"
+#include "third_party/blink/renderer/core/html_names.h"
+#include "third_party/blink/renderer/core/testing/page_test_base.h"
+
+namespace blink {
+
+class PendingAttributeChangesTest : public PageTestBase {};
+
+TEST_F(PendingAttributeChangesTest, CoalescesChangesOfOneAttribute) {
+  auto *element = GetDocument().CreateRawElement(html_names::kDivTag);
+  auto& changes = PendingAttributeChanges::From(GetDocument());
+  const auto reason = Element::AttributeModificationReason::kDirectly;
+
+  EXPECT_TRUE(changes.Add(*element, html_names::kTitleAttr, g_null_atom, "a", reason));
+  EXPECT_TRUE(changes.Add(*element, html_names::kTitleAttr, "a", "b", reason));
+  Vector<PendingAttributeChanges::Change> taken = changes.Take(*element);
+  ASSERT_EQ(1u, taken.size());
+  EXPECT_EQ(g_null_atom, taken[0].old_value);
+  EXPECT_EQ("b", taken[0].new_value);
+}
+
+TEST_F(PendingAttributeChangesTest, DropsChangesThatCancelOut) {
+  auto *element = GetDocument().CreateRawElement(html_names::kDivTag);
+  auto& changes = PendingAttributeChanges::From(GetDocument());
+  const auto reason = Element::AttributeModificationReason::kDirectly;
+
+  // Set, then removed while pending.
+  EXPECT_TRUE(changes.Add(*element, html_names::kTitleAttr, g_null_atom, "a", reason));
+  EXPECT_FALSE(changes.Add(*element, html_names::kTitleAttr, "a", g_null_atom, reason));
+  EXPECT_TRUE(changes.Take(*element).IsEmpty());
+
+  // Written back to the original value; the other attribute stays queued.
+  EXPECT_TRUE(changes.Add(*element, html_names::kTitleAttr, "a", "b", reason));
+  EXPECT_TRUE(changes.Add(*element, html_names::kLangAttr, g_null_atom, "en", reason));
+  EXPECT_TRUE(changes.Add(*element, html_names::kTitleAttr, "b", "a", reason));
+  Vector<PendingAttributeChanges::Change> taken = changes.Take(*element);
+  ASSERT_EQ(1u, taken.size());
+  EXPECT_EQ(html_names::kLangAttr, taken[0].name);
+}
+
+}  // namespace blink
@@ -0,0 +1,41 @@
+#include "third_party/blink/renderer/core/frame/dom_constraint_config.h"
+
+namespace blink {
+
+DOMConstraintConfig::DOMConstraintConfig(const String& mode_string)
+    : mode_(Mode::kIdle) {
+  if (mode_string.IsEmpty()) {
+    return;
+  }
+  if (mode_string[0] == 'r') {
+    mode_ = Mode::kRecord;
+  } else if (mode_string[0] == 'e') {
+    mode_ = Mode::kEnforce;
+  }
+  mode_string.Substring(1).Split(" ", false, id_prefixes_);
+}
+
+const DOMConstraintConfig& DOMConstraintConfig::Detached() {
+  DEFINE_STATIC_LOCAL(Persistent<DOMConstraintConfig>, detached_config, (MakeGarbageCollected<DOMConstraintConfig>("r")));
+  return *detached_config;
+}
+
+bool DOMConstraintConfig::HasIdPrefix(const AtomicString& id) const {
+  for (const String& prefix : id_prefixes_) {
+    if (id.StartsWith(prefix)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool DOMConstraintConfig::ShareIdPrefix(const AtomicString& shadow_id, const AtomicString& actual_id) const {
+  for (const String& prefix : id_prefixes_) {
+    if (shadow_id.StartsWith(prefix) && actual_id.StartsWith(prefix)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace blink
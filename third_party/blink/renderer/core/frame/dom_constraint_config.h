@@ -0,0 +1,51 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_CONFIG_H_
+#define THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_CONFIG_H_
+
+#include "third_party/blink/renderer/core/core_export.h"
+#include "third_party/blink/renderer/platform/heap/handle.h"
+#include "third_party/blink/renderer/platform/wtf/text/atomic_string.h"
+#include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
+#include "third_party/blink/renderer/platform/wtf/vector.h"
+
+namespace blink {
+
+// A DOM constraint mode string, parsed once when the mode is set. The first
+// character selects the mode: 'r' records, 'e' enforces, and anything else
+// leaves DOMGuard idle. The rest is a space separated list of id prefixes;
+// two ids that start with the same one of them are considered equal, so
+// elements with generated ids still pair with their shadow elements.
+//
+// A config never changes; setting another mode replaces it.
+class CORE_EXPORT DOMConstraintConfig final
+    : public GarbageCollected<DOMConstraintConfig> {
+ public:
+  enum class Mode { kIdle, kRecord, kEnforce };
+
+  explicit DOMConstraintConfig(const String& mode_string);
+
+  // The config DOMGuard uses for elements without a frame, such as the shadow
+  // elements themselves: record mode without id prefixes.
+  static const DOMConstraintConfig& Detached();
+
+  Mode GetMode() const { return mode_; }
+  bool IsRecording() const { return mode_ == Mode::kRecord; }
+
+  // Whether |id| starts with one of the id prefixes.
+  bool HasIdPrefix(const AtomicString& id) const;
+  // Whether |shadow_id| and |actual_id| start with the same id prefix.
+  bool ShareIdPrefix(const AtomicString& shadow_id, const AtomicString& actual_id) const;
+
+  void Trace(Visitor*) const {}
+
+ private:
+  Mode mode_;
+  Vector<String> id_prefixes_;
+};
+
+}  // namespace blink
+
+#endif  // THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_CONFIG_H_
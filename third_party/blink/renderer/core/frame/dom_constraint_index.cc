@@ -0,0 +1,111 @@
+#include "third_party/blink/renderer/core/frame/dom_constraint_index.h"
+
+#include "third_party/blink/renderer/core/css/css_value.h"
+#include "third_party/blink/renderer/core/css/properties/computed_style_utils.h"
+#include "third_party/blink/renderer/core/css/properties/css_property.h"
+#include "third_party/blink/renderer/core/dom/document.h"
+#include "third_party/blink/renderer/core/dom/document_fragment.h"
+#include "third_party/blink/renderer/core/dom/element.h"
+#include "third_party/blink/renderer/core/dom/node.h"
+#include "third_party/blink/renderer/core/dom/node_computed_style.h"
+#include "third_party/blink/renderer/core/style/computed_style.h"
+
+namespace blink {
+
+ShadowStyleTexts::ShadowStyleTexts(const ComputedStyle* style) : style_(style) {}
+
+const AtomicString& ShadowStyleTexts::Get(const CSSProperty& property) {
+  auto result = texts_.insert(static_cast<unsigned>(property.PropertyID()), g_empty_atom);
+  if (result.is_new_entry) {
+    const CSSValue *css_value = ComputedStyleUtils::ComputedPropertyValue(property, *style_);
+    if (css_value) {
+      result.stored_value->value = AtomicString(css_value->CssText());
+    }
+  }
+  return result.stored_value->value;
+}
+
+DOMConstraintIndex::DOMConstraintIndex(Document& dom_constraint, bool copy_on_write)
+    : overlay_(MakeGarbageCollected<DOMConstraintOverlay>(dom_constraint, copy_on_write)), tree_(dom_constraint, *overlay_) {}
+
+DOMConstraintTree::NodeId DOMConstraintIndex::AppendShadowChild(DOMConstraintTree::NodeId shadow_parent, Element* shadow_child) {
+  overlay_->AppendChild(tree_.GetNode(shadow_parent), shadow_child);
+  return tree_.DidAppendChild(shadow_parent, shadow_child);
+}
+
+void DOMConstraintIndex::DidChangeShadowAttributes(DOMConstraintTree::NodeId shadow_node) {
+  tree_.DidChangeAttributes(shadow_node);
+}
+
+// static
+Node* DOMConstraintIndex::BindingParent(Node* node) {
+  Node *parent = node->ParentOrShadowHostNode();
+  while (parent && DynamicTo<DocumentFragment>(parent)) {
+    parent = parent->ParentOrShadowHostNode();
+  }
+  return parent;
+}
+
+ShadowBinding* DOMConstraintIndex::GetBinding(Element* element, ShadowBindingKind kind) const {
+  const BindingMap& bindings = Bindings(kind);
+  auto it = bindings.find(element);
+  if (it == bindings.end() || it->value->id != element->GetIdAttribute()) {
+    return nullptr;
+  }
+  ShadowBinding *binding = it->value.Get();
+  if (binding->generation != generation_) {
+    // The parent is checked the same way, so a moved ancestor anywhere above invalidates the binding.
+    DOMConstraintTree::NodeId parent_shadow = ParentShadow(element, kind);
+    if (parent_shadow == kNotFound || parent_shadow != binding->parent_shadow) {
+      return nullptr;
+    }
+    binding->generation = generation_;
+  }
+  return binding;
+}
+
+void DOMConstraintIndex::SetBinding(Element* element, ShadowBindingKind kind, DOMConstraintTree::NodeId shadow_node, unsigned match_result) {
+  DOMConstraintTree::NodeId parent_shadow = ParentShadow(element, kind);
+  if (parent_shadow == kNotFound) {
+    return;
+  }
+  Bindings(kind).Set(element, MakeGarbageCollected<ShadowBinding>(shadow_node, parent_shadow, element->GetIdAttribute(), match_result, generation_));
+}
+
+DOMConstraintTree::NodeId DOMConstraintIndex::ParentShadow(Element* element, ShadowBindingKind kind) const {
+  Node *parent = BindingParent(element);
+  if (DynamicTo<Document>(parent)) {
+    return DOMConstraintTree::kDocumentId;
+  }
+  auto *parent_element = DynamicTo<Element>(parent);
+  if (!parent_element) {
+    return kNotFound;
+  }
+  ShadowBinding *parent_binding = GetBinding(parent_element, kind);
+  return parent_binding ? parent_binding->shadow_node : kNotFound;
+}
+
+void DOMConstraintIndex::ClearBindings() {
+  enforce_bindings_.clear();
+  record_bindings_.clear();
+}
+
+const AtomicString& DOMConstraintIndex::ShadowStyleText(Element* shadow_element, const CSSProperty& property) {
+  const ComputedStyle *style = shadow_element->GetComputedStyle();
+  auto result = shadow_style_texts_.insert(shadow_element, nullptr);
+  if (result.is_new_entry || result.stored_value->value->Style() != style) {
+    result.stored_value->value = MakeGarbageCollected<ShadowStyleTexts>(style);
+  }
+  return result.stored_value->value->Get(property);
+}
+
+void DOMConstraintIndex::Trace(Visitor* visitor) const {
+  visitor->Trace(overlay_);
+  visitor->Trace(tree_);
+  visitor->Trace(enforce_bindings_);
+  visitor->Trace(record_bindings_);
+  visitor->Trace(shadow_style_texts_);
+  visitor->Trace(css_value_cache_);
+}
+
+}  // namespace blink
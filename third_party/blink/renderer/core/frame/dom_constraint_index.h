@@ -0,0 +1,147 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_INDEX_H_
+#define THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_INDEX_H_
+
+#include "base/memory/scoped_refptr.h"
+#include "third_party/blink/renderer/core/core_export.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_overlay.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_pattern.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_tree.h"
+#include "third_party/blink/renderer/platform/heap/handle.h"
+#include "third_party/blink/renderer/platform/wtf/hash_map.h"
+#include "third_party/blink/renderer/platform/wtf/text/atomic_string.h"
+#include "third_party/blink/renderer/platform/wtf/text/atomic_string_hash.h"
+#include "third_party/blink/renderer/platform/wtf/vector.h"
+
+namespace blink {
+
+class ComputedStyle;
+class CSSProperty;
+class Document;
+class Element;
+class Node;
+
+// The shadow node a live Element resolved to, memoized so that probes on the
+// same element do not have to walk and re-match all of its ancestors. Shadow
+// nodes are held as DOMConstraintTree NodeIds, so a binding has nothing to
+// trace.
+class CORE_EXPORT ShadowBinding final : public GarbageCollected<ShadowBinding> {
+ public:
+  ShadowBinding(DOMConstraintTree::NodeId shadow_node, DOMConstraintTree::NodeId parent_shadow, const AtomicString& id, unsigned match_result, unsigned generation)
+      : shadow_node(shadow_node), parent_shadow(parent_shadow), id(id), match_result(match_result), generation(generation) {}
+
+  void Trace(Visitor*) const {}
+
+  DOMConstraintTree::NodeId shadow_node;
+  // What the element's parent was bound to when the element was bound; once
+  // the parent is bound to anything else, the binding no longer holds.
+  DOMConstraintTree::NodeId parent_shadow;
+  // The element's id when it was bound; an id change invalidates the binding.
+  AtomicString id;
+  // A DOMGuard::ShadowTreeMatchResult.
+  unsigned match_result;
+  // The DOMConstraintIndex generation in which |parent_shadow| was last
+  // found to hold.
+  unsigned generation;
+};
+
+// The serialized computed values of one shadow element's ComputedStyle,
+// interned so that equal values share a single AtomicString. Values are
+// serialized the first time a property is asked for and kept for as long as
+// the element keeps the same ComputedStyle.
+class CORE_EXPORT ShadowStyleTexts final
+    : public GarbageCollected<ShadowStyleTexts> {
+ public:
+  explicit ShadowStyleTexts(const ComputedStyle*);
+
+  const ComputedStyle* Style() const { return style_.get(); }
+  // The CssText() of |property|'s computed value, or the empty atom where
+  // there is none.
+  const AtomicString& Get(const CSSProperty& property);
+
+  void Trace(Visitor*) const {}
+
+ private:
+  scoped_refptr<const ComputedStyle> style_;
+  // Keyed by CSSPropertyID.
+  HashMap<unsigned, AtomicString> texts_;
+};
+
+// Record mode creates missing shadow ancestors and ignores "dtt-whitelist",
+// so it resolves elements differently from enforce mode.
+enum class ShadowBindingKind { kEnforce, kRecord };
+
+// Per-constraint state of a LocalFrame. One is created for every constraint
+// document installed on a frame: the flat DOMConstraintTree that enforcement
+// reads the constraint from, the DOMConstraintOverlay that record mode writes
+// through, the ShadowBindings of live elements, the serialized styles of
+// shadow elements and the parsed shadow CSS alternatives. Replacing the
+// constraint replaces the whole object, which drops all of them at once. The
+// tree covers the overlay as well as the document.
+class CORE_EXPORT DOMConstraintIndex final
+    : public GarbageCollected<DOMConstraintIndex> {
+ public:
+  // |copy_on_write| is passed on to the DOMConstraintOverlay; it must be set
+  // if |dom_constraint| is shared with other frames.
+  DOMConstraintIndex(Document& dom_constraint, bool copy_on_write);
+
+  DOMConstraintOverlay& Overlay() const { return *overlay_; }
+
+  // Appends |shadow_child|, created by the overlay, through the overlay and
+  // returns its NodeId.
+  DOMConstraintTree::NodeId AppendShadowChild(DOMConstraintTree::NodeId shadow_parent, Element* shadow_child);
+  // Must be called when record mode changes the attributes of a shadow element
+  // that is already in the constraint tree.
+  void DidChangeShadowAttributes(DOMConstraintTree::NodeId shadow_node);
+
+  DOMConstraintTree& Tree() { return tree_; }
+  const DOMConstraintTree& Tree() const { return tree_; }
+
+  // The node an element is bound below: its parent or shadow host, skipping
+  // document fragments.
+  static Node* BindingParent(Node*);
+  // Returns nullptr if |element| has no binding, if its id changed since, or
+  // if its BindingParent() is no longer bound to the same shadow node. The
+  // last check only runs once per generation.
+  ShadowBinding* GetBinding(Element*, ShadowBindingKind) const;
+  // Does nothing unless the BindingParent() of |element| is the document or
+  // bound itself, so that every binding can be checked against its parent.
+  void SetBinding(Element*, ShadowBindingKind, DOMConstraintTree::NodeId shadow_node, unsigned match_result);
+  // Starts a new generation, in which every binding checks its parent again
+  // before it is used. Called when a subtree may have moved or an id changed;
+  // bindings below are found stale lazily instead of walking the subtree.
+  void MarkBindingsUnverified() { ++generation_; }
+  void ClearBindings();
+
+  // Returns the interned serialized computed value of |property| on
+  // |shadow_element|, which must have a ComputedStyle.
+  const AtomicString& ShadowStyleText(Element* shadow_element, const CSSProperty& property);
+
+  ShadowCSSValueCache& CSSValueCache() { return css_value_cache_; }
+
+  void Trace(Visitor*) const;
+
+ private:
+  using BindingMap = HeapHashMap<WeakMember<Element>, Member<ShadowBinding>>;
+
+  BindingMap& Bindings(ShadowBindingKind kind) { return kind == ShadowBindingKind::kEnforce ? enforce_bindings_ : record_bindings_; }
+  const BindingMap& Bindings(ShadowBindingKind kind) const { return kind == ShadowBindingKind::kEnforce ? enforce_bindings_ : record_bindings_; }
+  // What the BindingParent() of |element| is bound to: the constraint document
+  // for the document, kNotFound if it is not bound.
+  DOMConstraintTree::NodeId ParentShadow(Element*, ShadowBindingKind) const;
+
+  Member<DOMConstraintOverlay> overlay_;
+  DOMConstraintTree tree_;
+  BindingMap enforce_bindings_;
+  BindingMap record_bindings_;
+  unsigned generation_ = 0;
+  HeapHashMap<WeakMember<Element>, Member<ShadowStyleTexts>> shadow_style_texts_;
+  ShadowCSSValueCache css_value_cache_;
+};
+
+}  // namespace blink
+
+#endif  // THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_INDEX_H_
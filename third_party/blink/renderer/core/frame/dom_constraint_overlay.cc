@@ -0,0 +1,141 @@
+#include "third_party/blink/renderer/core/frame/dom_constraint_overlay.h"
+
+#include "third_party/blink/renderer/core/dom/document.h"
+#include "third_party/blink/renderer/core/dom/document_init.h"
+#include "third_party/blink/renderer/core/dom/element.h"
+#include "third_party/blink/renderer/core/dom/node.h"
+#include "third_party/blink/renderer/core/dom/qualified_name.h"
+
+namespace blink {
+
+namespace {
+
+Document* CreateConstraintDocument() {
+  Document* doc = DocumentInit::Create()
+                    .WithTypeFrom("text/html")
+                    .CreateDocument();
+  doc->setAllowDeclarativeShadowRoots(false);
+  doc->SetMimeType(AtomicString("text/html"));
+  return doc;
+}
+
+}  // namespace
+
+DOMConstraintOverlay::DOMConstraintOverlay(Document& base, bool copy_on_write)
+    : base_(&base), overlay_document_(copy_on_write ? CreateConstraintDocument() : &base), copy_on_write_(copy_on_write) {}
+
+Element* DOMConstraintOverlay::CreateElement(const AtomicString& tag_name) {
+  return overlay_document_->CreateRawElement(QualifiedName(g_null_atom, tag_name, g_null_atom));
+}
+
+void DOMConstraintOverlay::AppendChild(Node* shadow_parent, Element* shadow_child) {
+  // New elements are private to the overlay, so they can take children of their own.
+  if (!copy_on_write_ || &shadow_parent->GetDocument() != base_) {
+    shadow_parent->appendChild(shadow_child);
+    return;
+  }
+  auto result = added_children_.insert(shadow_parent, nullptr);
+  if (result.is_new_entry) {
+    result.stored_value->value = MakeGarbageCollected<HeapVector<Member<Element>>>();
+  }
+  result.stored_value->value->push_back(shadow_child);
+}
+
+const HeapVector<Member<Element>>* DOMConstraintOverlay::AddedChildren(Node* shadow_parent) const {
+  auto it = added_children_.find(shadow_parent);
+  return it == added_children_.end() ? nullptr : it->value.Get();
+}
+
+Element* DOMConstraintOverlay::Current(Element* shadow_element) const {
+  auto it = element_copies_.find(shadow_element);
+  return it == element_copies_.end() ? shadow_element : it->value.Get();
+}
+
+Element* DOMConstraintOverlay::EnsureWritable(Element* shadow_element) {
+  if (!copy_on_write_ || &shadow_element->GetDocument() != base_) {
+    return shadow_element;
+  }
+  auto it = element_copies_.find(shadow_element);
+  if (it != element_copies_.end()) {
+    return it->value.Get();
+  }
+  Element *copy = FoldElement(*shadow_element, *overlay_document_, false);
+  element_copies_.insert(shadow_element, copy);
+  return copy;
+}
+
+Document* DOMConstraintOverlay::Fold(bool delta_only) const {
+  Document* doc = CreateConstraintDocument();
+  if (!delta_only) {
+    FoldChildren(*base_, *doc, nullptr);
+    return doc;
+  }
+
+  // Every base element that changed or has a change below it.
+  HeapHashSet<Member<Node>> changed_paths;
+  auto add_path = [this, &changed_paths](Node* node) {
+    while (node && node != base_ && changed_paths.insert(node).is_new_entry) {
+      node = node->parentNode();
+    }
+  };
+  for (const auto& added_children : added_children_) {
+    add_path(added_children.key.Get());
+  }
+  for (const auto& element_copy : element_copies_) {
+    add_path(element_copy.key.Get());
+  }
+  FoldChildren(*base_, *doc, &changed_paths);
+  return doc;
+}
+
+void DOMConstraintOverlay::FoldChildren(Node& shadow_parent, Node& folded_parent, const HeapHashSet<Member<Node>>* changed_paths) const {
+  Document& folded_document = folded_parent.GetDocument();
+  for (auto *child = shadow_parent.firstChild(); child; child = child->nextSibling()) {
+    Element *child_element = DynamicTo<Element>(child);
+    if (!child_element || (changed_paths && !changed_paths->Contains(child_element))) {
+      continue;
+    }
+    bool path_only = changed_paths && !element_copies_.Contains(child_element);
+    Element *folded_element = FoldElement(*child_element, folded_document, path_only);
+    folded_parent.appendChild(folded_element);
+    FoldChildren(*child_element, *folded_element, changed_paths);
+  }
+
+  const HeapVector<Member<Element>>* added_children = AddedChildren(&shadow_parent);
+  if (!added_children) {
+    return;
+  }
+  for (Element* added_child : *added_children) {
+    Element *folded_element = FoldElement(*added_child, folded_document, false);
+    folded_parent.appendChild(folded_element);
+    // New elements are kept whole, even in a delta.
+    FoldChildren(*added_child, *folded_element, nullptr);
+  }
+}
+
+Element* DOMConstraintOverlay::FoldElement(Element& shadow_element, Document& folded_document, bool path_only) const {
+  Element *folded_element = folded_document.CreateRawElement(QualifiedName(g_null_atom, AtomicString(shadow_element.tagName()), g_null_atom));
+  if (path_only) {
+    for (const char* name : {"dtt-id", "dtt-dangling"}) {
+      const AtomicString& value = shadow_element.getAttribute(name);
+      if (!value.IsNull()) {
+        folded_element->setAttribute(name, value);
+      }
+    }
+    folded_element->setAttribute("dtt-path", "");
+    return folded_element;
+  }
+  for (const Attribute& attribute : Current(&shadow_element)->Attributes()) {
+    folded_element->setAttribute(attribute.GetName(), attribute.Value());
+  }
+  return folded_element;
+}
+
+void DOMConstraintOverlay::Trace(Visitor* visitor) const {
+  visitor->Trace(base_);
+  visitor->Trace(overlay_document_);
+  visitor->Trace(added_children_);
+  visitor->Trace(element_copies_);
+}
+
+}  // namespace blink
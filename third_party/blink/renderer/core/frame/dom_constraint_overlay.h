@@ -0,0 +1,84 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_OVERLAY_H_
+#define THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_OVERLAY_H_
+
+#include "third_party/blink/renderer/core/core_export.h"
+#include "third_party/blink/renderer/platform/heap/handle.h"
+#include "third_party/blink/renderer/platform/heap/heap_allocator.h"
+#include "third_party/blink/renderer/platform/wtf/text/atomic_string.h"
+
+namespace blink {
+
+class Document;
+class Element;
+class Node;
+
+// What record mode adds to a DOM constraint. Record mode makes every change
+// to the constraint through here: new shadow elements, and attribute values
+// (merged alternatives and "dtt-s-*" style values) of existing ones.
+//
+// A constraint that is private to its frame is simply written through. A
+// shared one (see LocalFrame::SetDOMConstraintData()) is copied on write
+// instead, and never modified:
+//   - new shadow elements are created in a private document; those appended
+//     below a base node are listed per base parent, those appended below
+//     other new elements are ordinary DOM children of them.
+//   - a base element whose attributes change gets a private, childless copy
+//     that holds its current attributes from then on.
+// Recording on top of a large shared constraint therefore only costs as much
+// as what is recorded, and dropping the overlay discards the session.
+//
+// Children appended here come after the DOM children of their parent, which
+// is where appending them to the base would have put them.
+class CORE_EXPORT DOMConstraintOverlay final
+    : public GarbageCollected<DOMConstraintOverlay> {
+ public:
+  DOMConstraintOverlay(Document& base, bool copy_on_write);
+
+  bool IsCopyOnWrite() const { return copy_on_write_; }
+  // True if the base holds everything that was recorded.
+  bool IsEmpty() const { return added_children_.IsEmpty() && element_copies_.IsEmpty(); }
+
+  // Creates a shadow element that is not part of the constraint until it is
+  // appended.
+  Element* CreateElement(const AtomicString& tag_name);
+  // |shadow_child| must come from CreateElement().
+  void AppendChild(Node* shadow_parent, Element* shadow_child);
+  // The children appended below the base node |shadow_parent|, in order, or
+  // nullptr if there are none.
+  const HeapVector<Member<Element>>* AddedChildren(Node* shadow_parent) const;
+
+  // The element that holds the current attributes of |shadow_element|.
+  Element* Current(Element* shadow_element) const;
+  // Like Current(), but first copies a base element of a shared constraint so
+  // that its attributes can be changed.
+  Element* EnsureWritable(Element* shadow_element);
+
+  // Returns a new, unstyled constraint document with everything recorded
+  // applied to the base. With |delta_only|, elements that neither changed nor
+  // lead to one that did are left out, and the ancestors that only lead to a
+  // change are reduced to their tag and "dtt-id" and marked "dtt-path". Such a
+  // delta can be kept, shipped and merged into its base on its own.
+  Document* Fold(bool delta_only) const;
+
+  void Trace(Visitor*) const;
+
+ private:
+  void FoldChildren(Node& shadow_parent, Node& folded_parent, const HeapHashSet<Member<Node>>* changed_paths) const;
+  Element* FoldElement(Element& shadow_element, Document& folded_document, bool path_only) const;
+
+  Member<Document> base_;
+  // Where new shadow elements and copies of base elements are created. The
+  // base itself if it is written through.
+  Member<Document> overlay_document_;
+  HeapHashMap<Member<Node>, Member<HeapVector<Member<Element>>>> added_children_;
+  HeapHashMap<Member<Element>, Member<Element>> element_copies_;
+  const bool copy_on_write_;
+};
+
+}  // namespace blink
+
+#endif  // THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_OVERLAY_H_
@@ -0,0 +1,354 @@
+#include "third_party/blink/renderer/core/frame/dom_constraint_pattern.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "third_party/blink/renderer/core/css/css_numeric_literal_value.h"
+#include "third_party/blink/renderer/core/css/css_primitive_value.h"
+#include "third_party/blink/renderer/core/css/css_property_names.h"
+#include "third_party/blink/renderer/core/css/css_value.h"
+#include "third_party/blink/renderer/core/css/parser/css_parser.h"
+#include "third_party/blink/renderer/core/frame/v8_scanner/scanner-character-streams.h"
+#include "third_party/blink/renderer/platform/wtf/text/ascii_ctype.h"
+#include "third_party/blink/renderer/platform/wtf/text/string_builder.h"
+
+namespace blink {
+
+namespace {
+
+bool HasGlobCharacters(const String& alternative) {
+  return alternative.find('*') != kNotFound || alternative.find('?') != kNotFound || alternative.find('\\') != kNotFound;
+}
+
+// Splits |value| into runs that alternate between non-digits and digits, starting with a possibly empty run of
+// non-digits.
+Vector<String> SplitDigitRuns(const String& value) {
+  Vector<String> runs;
+  wtf_size_t run_start = 0;
+  bool in_digits = false;
+  for (wtf_size_t i = 0; i < value.length(); ++i) {
+    if (IsASCIIDigit(value[i]) != in_digits) {
+      runs.push_back(value.Substring(run_start, i - run_start));
+      run_start = i;
+      in_digits = !in_digits;
+    }
+  }
+  runs.push_back(value.Substring(run_start));
+  return runs;
+}
+
+// Returns a glob matching every one of |values|, which are free of glob characters: their common prefix and suffix
+// around a '?' for every position that varies if they are equally long, or around a single '*' otherwise.
+String GeneralizeLiterals(const Vector<String>& values) {
+  const String& first = values.front();
+  wtf_size_t min_length = first.length();
+  bool same_length = true;
+  for (const String& value : values) {
+    min_length = std::min(min_length, value.length());
+    same_length = same_length && value.length() == first.length();
+  }
+  wtf_size_t prefix_length = 0;
+  while (prefix_length < min_length && std::all_of(values.begin(), values.end(), [&](const String& value) { return value[prefix_length] == first[prefix_length]; })) {
+    prefix_length += 1;
+  }
+  wtf_size_t suffix_length = 0;
+  while (prefix_length + suffix_length < min_length && std::all_of(values.begin(), values.end(), [&](const String& value) { return value[value.length() - suffix_length - 1] == first[first.length() - suffix_length - 1]; })) {
+    suffix_length += 1;
+  }
+
+  StringBuilder glob;
+  glob.Append(first.Left(prefix_length));
+  if (same_length) {
+    for (wtf_size_t i = prefix_length; i < first.length() - suffix_length; ++i) {
+      bool fixed = std::all_of(values.begin(), values.end(), [&](const String& value) { return value[i] == first[i]; });
+      glob.Append(fixed ? first[i] : static_cast<UChar>('?'));
+    }
+  } else {
+    glob.Append('*');
+  }
+  glob.Append(first.Right(suffix_length));
+  return glob.ToString();
+}
+
+// Generalizes values that share their non-digit runs one run of digits at a time, so that "item-1203-a" and
+// "item-1297-a" become "item-12??-a" and ids with counters of different widths keep everything but the counter.
+String GeneralizeDigitRuns(const Vector<Vector<String>>& runs_of_values) {
+  StringBuilder glob;
+  Vector<String> column;
+  for (wtf_size_t i = 0; i < runs_of_values.front().size(); ++i) {
+    if (i % 2 == 0) {
+      glob.Append(runs_of_values.front()[i]);
+      continue;
+    }
+    column.Shrink(0);
+    for (const Vector<String>& runs : runs_of_values) {
+      column.push_back(runs[i]);
+    }
+    glob.Append(GeneralizeLiterals(column));
+  }
+  return glob.ToString();
+}
+
+// Returns false unless |value| is a single number. Absolute units are converted to the canonical unit of their
+// category; relative ones such as em or % are kept as they are.
+bool NormalizeNumericValue(const CSSValue& value, unsigned& unit, double& number) {
+  const auto* numeric_value = DynamicTo<CSSNumericLiteralValue>(value);
+  if (!numeric_value) {
+    return false;
+  }
+  CSSPrimitiveValue::UnitType unit_type = numeric_value->GetType();
+  CSSPrimitiveValue::UnitType canonical_unit_type = CSSPrimitiveValue::CanonicalUnitTypeForCategory(CSSPrimitiveValue::UnitTypeToUnitCategory(unit_type));
+  number = numeric_value->DoubleValue();
+  if (canonical_unit_type != CSSPrimitiveValue::UnitType::kUnknown) {
+    number *= CSSPrimitiveValue::ConversionToCanonicalUnitsScaleFactor(unit_type);
+    unit_type = canonical_unit_type;
+  }
+  unit = static_cast<unsigned>(unit_type);
+  return true;
+}
+
+void AppendEscapedAlternative(StringBuilder& builder, const String& alternative) {
+  for (wtf_size_t i = 0; i < alternative.length(); ++i) {
+    if (alternative[i] == '\\' || alternative[i] == '|') {
+      builder.Append('\\');
+    }
+    builder.Append(alternative[i]);
+  }
+}
+
+}  // namespace
+
+v8_scanner::Scanner& ResetScriptScanner(v8_scanner::ReusableScanner& scanner, const String& script) {
+  if (script.IsEmpty()) {
+    return scanner.Reset(static_cast<const uint8_t*>(nullptr), 0);
+  }
+  if (script.Is8Bit()) {
+    return scanner.Reset(script.Characters8(), script.length());
+  }
+  return scanner.Reset(reinterpret_cast<const uint16_t*>(script.Characters16()), script.length());
+}
+
+void ScriptTokenSequence::Assign(v8_scanner::ReusableScanner& scanner, const String& script) {
+  v8_scanner::Scanner& script_scanner = ResetScriptScanner(scanner, script);
+  tokens.Shrink(0);
+  hash = 0;
+  v8_scanner::Token::Value token;
+  do {
+    token = script_scanner.Next();
+    tokens.push_back(token);
+    hash = hash * 31 + token + 1;
+  } while (token != v8_scanner::Token::EOS && token != v8_scanner::Token::ILLEGAL);
+}
+
+bool ScriptTokenSequence::Equals(const ScriptTokenSequence& other) const {
+  return hash == other.hash && tokens.size() == other.tokens.size() && !memcmp(tokens.data(), other.tokens.data(), tokens.size());
+}
+
+const CSSValue* ShadowCSSValueCache::Get(CSSPropertyID property_id, const AtomicString& text, const CSSParserContext* parser_context) {
+  if (parser_context_ != parser_context) {
+    parser_context_ = parser_context;
+    values_.clear();
+  }
+  auto result = values_.insert(Key(static_cast<unsigned>(property_id), text), nullptr);
+  if (result.is_new_entry) {
+    result.stored_value->value = CSSParser::ParseSingleValue(property_id, text, parser_context);
+  }
+  return result.stored_value->value.Get();
+}
+
+void ShadowCSSValueCache::Trace(Visitor* visitor) const {
+  visitor->Trace(parser_context_);
+  visitor->Trace(values_);
+}
+
+DOMConstraintPattern::DOMConstraintPattern(const AtomicString& source)
+    : source_(source), css_property_id_(CSSPropertyID::kInvalid) {
+  if (source_.IsNull()) {
+    return;
+  }
+  AppendAlternatives(0);
+}
+
+void DOMConstraintPattern::AppendAlternatives(wtf_size_t start) {
+  wtf_size_t source_length = source_.length();
+  bool is_escaped_character = false;
+  StringBuilder unescaped_current_part_builder;
+  for (wtf_size_t i = start; i < source_length; ++i) {
+    if (is_escaped_character) {
+      is_escaped_character = false;
+      unescaped_current_part_builder.Append(source_[i]);
+    } else {
+      if (source_[i] == '\\') {
+        is_escaped_character = true;
+      } else if (source_[i] == '|') {
+        alternatives_.push_back(unescaped_current_part_builder.ToAtomicString());
+        unescaped_current_part_builder.Clear();
+      } else {
+        unescaped_current_part_builder.Append(source_[i]);
+      }
+    }
+  }
+  alternatives_.push_back(unescaped_current_part_builder.ToAtomicString());
+  ends_with_escape_ = is_escaped_character;
+}
+
+bool DOMConstraintPattern::Extend(const AtomicString& source) {
+  wtf_size_t length = source_.length();
+  if (source_.IsNull() || ends_with_escape_ || source.length() <= length || source[length] != '|' || !source.GetString().StartsWith(source_.GetString())) {
+    return false;
+  }
+  source_ = source;
+  AppendAlternatives(length + 1);
+  return true;
+}
+
+const Vector<KURL>& DOMConstraintPattern::Urls() {
+  while (urls_.size() < alternatives_.size()) {
+    urls_.push_back(KURL(alternatives_[urls_.size()]));
+  }
+  return urls_;
+}
+
+const HeapVector<Member<const CSSValue>>& DOMConstraintPattern::CssValues(CSSPropertyID property_id, const CSSParserContext* parser_context, ShadowCSSValueCache& cache) {
+  if (!has_css_values_ || css_property_id_ != property_id || css_parser_context_ != parser_context) {
+    has_css_values_ = true;
+    css_property_id_ = property_id;
+    css_parser_context_ = parser_context;
+    css_values_.clear();
+    css_values_.ReserveInitialCapacity(alternatives_.size());
+    numeric_ranges_.clear();
+  }
+  while (css_values_.size() < alternatives_.size()) {
+    const AtomicString& alternative = alternatives_[css_values_.size()];
+    const CSSValue* css_value = alternative.IsEmpty() ? nullptr : cache.Get(property_id, alternative, parser_context);
+    css_values_.push_back(css_value);
+    unsigned unit;
+    double number;
+    if (!css_value || !NormalizeNumericValue(*css_value, unit, number)) {
+      continue;
+    }
+    auto* it = std::find_if(numeric_ranges_.begin(), numeric_ranges_.end(), [unit](const CSSNumericRange& range) { return range.unit == unit; });
+    if (it == numeric_ranges_.end()) {
+      numeric_ranges_.push_back(CSSNumericRange{unit, number, number});
+    } else {
+      it->min = std::min(it->min, number);
+      it->max = std::max(it->max, number);
+    }
+  }
+  return css_values_;
+}
+
+bool DOMConstraintPattern::NumericRangesContain(const CSSValue& value, CSSPropertyID property_id, const CSSParserContext* parser_context, ShadowCSSValueCache& cache) {
+  unsigned unit;
+  double number;
+  if (!NormalizeNumericValue(value, unit, number)) {
+    return false;
+  }
+  CssValues(property_id, parser_context, cache);
+  for (const CSSNumericRange& range : numeric_ranges_) {
+    if (range.unit == unit) {
+      return range.min <= number && number <= range.max;
+    }
+  }
+  return false;
+}
+
+const Vector<ScriptTokenSequence>& DOMConstraintPattern::ScriptTokens(v8_scanner::ReusableScanner& scanner) {
+  wtf_size_t scanned = script_tokens_.size();
+  if (scanned < alternatives_.size()) {
+    script_tokens_.resize(alternatives_.size());
+    for (wtf_size_t i = scanned; i < alternatives_.size(); ++i) {
+      script_tokens_[i].Assign(scanner, alternatives_[i]);
+    }
+  }
+  return script_tokens_;
+}
+
+void DOMConstraintPattern::Trace(Visitor* visitor) const {
+  visitor->Trace(css_parser_context_);
+  visitor->Trace(css_values_);
+}
+
+AtomicString GeneralizeAlternatives(const DOMConstraintPattern& pattern, wtf_size_t max_alternatives) {
+  Vector<String> kept;
+  Vector<String> literals;
+  // Literals keyed by their non-digit runs, with the digit runs left out.
+  HashMap<String, wtf_size_t> group_by_shape;
+  Vector<Vector<Vector<String>>> groups;
+  Vector<Vector<String>> group_literals;
+  for (const AtomicString& alternative : pattern.Alternatives()) {
+    if (alternative.IsEmpty() || HasGlobCharacters(alternative)) {
+      kept.push_back(alternative);
+      continue;
+    }
+    literals.push_back(alternative);
+    Vector<String> runs = SplitDigitRuns(alternative);
+    StringBuilder shape;
+    for (wtf_size_t i = 0; i < runs.size(); i += 2) {
+      shape.Append(runs[i]);
+      shape.Append(static_cast<UChar>(0));
+    }
+    shape.AppendNumber(runs.size());
+    auto result = group_by_shape.insert(shape.ToString(), groups.size());
+    if (result.is_new_entry) {
+      groups.emplace_back();
+      group_literals.emplace_back();
+    }
+    groups[result.stored_value->value].push_back(std::move(runs));
+    group_literals[result.stored_value->value].push_back(alternative);
+  }
+  if (literals.IsEmpty()) {
+    return pattern.Source();
+  }
+
+  // A bare '*' would accept any value and so turn enforcement of the attribute off. Rather than that, the literals
+  // are only folded by shape, even past |max_alternatives|, and a shape whose glob is still a bare '*' keeps its
+  // literals.
+  Vector<String> globs;
+  if (kept.size() + groups.size() > max_alternatives) {
+    String glob = GeneralizeLiterals(literals);
+    if (glob != "*") {
+      globs.push_back(glob);
+    }
+  }
+  if (globs.IsEmpty()) {
+    for (wtf_size_t i = 0; i < groups.size(); ++i) {
+      String glob = GeneralizeDigitRuns(groups[i]);
+      if (glob == "*") {
+        globs.AppendVector(group_literals[i]);
+      } else {
+        globs.push_back(glob);
+      }
+    }
+  }
+
+  StringBuilder builder;
+  bool first = true;
+  for (const Vector<String>* alternatives : {&kept, &globs}) {
+    for (const String& alternative : *alternatives) {
+      if (!first) {
+        builder.Append('|');
+      }
+      first = false;
+      AppendEscapedAlternative(builder, alternative);
+    }
+  }
+  return builder.ToAtomicString();
+}
+
+DOMConstraintPattern* ShadowElementPatterns::Get(const AtomicString& attribute_name, const AtomicString& value) {
+  auto result = patterns_.insert(attribute_name, nullptr);
+  if (result.is_new_entry) {
+    result.stored_value->value = MakeGarbageCollected<DOMConstraintPattern>(value);
+  } else if (result.stored_value->value->Source() != value && !result.stored_value->value->Extend(value)) {
+    result.stored_value->value = MakeGarbageCollected<DOMConstraintPattern>(value);
+  }
+  return result.stored_value->value.Get();
+}
+
+void ShadowElementPatterns::Trace(Visitor* visitor) const {
+  visitor->Trace(patterns_);
+}
+
+}  // namespace blink
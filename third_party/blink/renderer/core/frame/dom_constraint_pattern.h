@@ -0,0 +1,165 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_PATTERN_H_
+#define THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_PATTERN_H_
+
+#include "third_party/blink/renderer/core/core_export.h"
+#include "third_party/blink/renderer/platform/heap/handle.h"
+#include "third_party/blink/renderer/platform/weborigin/kurl.h"
+#include "third_party/blink/renderer/platform/wtf/hash_map.h"
+#include "third_party/blink/renderer/platform/wtf/text/atomic_string.h"
+#include "third_party/blink/renderer/platform/wtf/text/atomic_string_hash.h"
+#include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
+#include "third_party/blink/renderer/platform/wtf/vector.h"
+
+namespace v8_scanner {
+class ReusableScanner;
+class Scanner;
+}  // namespace v8_scanner
+
+namespace blink {
+
+class CSSParserContext;
+enum class CSSPropertyID;
+class CSSValue;
+
+// Points |scanner| at the characters of |script| in place and returns the
+// Scanner primed on its first token. |script| must outlive the scan.
+CORE_EXPORT v8_scanner::Scanner& ResetScriptScanner(v8_scanner::ReusableScanner& scanner, const String& script);
+
+// The v8_scanner token stream of a script, up to and including the EOS or
+// ILLEGAL token that ends it, together with a rolling hash of the sequence.
+// Two scripts are "script equal" exactly when their sequences are equal, so
+// differing hashes reject a pair without looking at the tokens.
+struct CORE_EXPORT ScriptTokenSequence {
+  DISALLOW_NEW();
+
+ public:
+  // Replaces the contents with the tokens of |script|. The token buffer is
+  // kept, so reusing one sequence for many scripts does not allocate.
+  void Assign(v8_scanner::ReusableScanner&, const String& script);
+  bool Equals(const ScriptTokenSequence& other) const;
+
+  Vector<uint8_t> tokens;
+  unsigned hash = 0;
+};
+
+// Parsed shadow CSS alternatives of one constraint, keyed by (property, text),
+// so that an alternative is parsed once however many shadow elements or record
+// mode merges carry it. New alternatives simply add keys, so entries never go
+// stale while the constraint lives; values parsed for another document's
+// parser context are dropped.
+class CORE_EXPORT ShadowCSSValueCache final {
+  DISALLOW_NEW();
+
+ public:
+  // Returns nullptr if |text| does not parse as a value of |property_id|.
+  const CSSValue* Get(CSSPropertyID property_id, const AtomicString& text, const CSSParserContext*);
+
+  void Trace(Visitor*) const;
+
+ private:
+  using Key = std::pair<unsigned, AtomicString>;
+
+  Member<const CSSParserContext> parser_context_;
+  HeapHashMap<Key, Member<const CSSValue>> values_;
+};
+
+// The range of numbers one unit of a CSS property was recorded with. Absolute
+// units are converted to the canonical unit of their category (lengths to px,
+// angles to deg, and so on), so "1in" and "96px" land in the same range.
+struct CSSNumericRange {
+  unsigned unit;
+  double min;
+  double max;
+};
+
+// The compiled form of a shadow attribute value such as `a|b\|c|*`. The value
+// is split on unescaped '|' and unescaped once, exactly like the DOMGuard
+// matchers used to do on every check; the URL and CSS interpretations of the
+// alternatives are derived on first use and then kept.
+class CORE_EXPORT DOMConstraintPattern final
+    : public GarbageCollected<DOMConstraintPattern> {
+ public:
+  explicit DOMConstraintPattern(const AtomicString& source);
+
+  const AtomicString& Source() const { return source_; }
+  bool IsNull() const { return source_.IsNull(); }
+  const Vector<AtomicString>& Alternatives() const { return alternatives_; }
+
+  // Takes on |source| if it is the current source with alternatives appended,
+  // as record mode merges leave it. Everything derived so far is kept and only
+  // the new alternatives are interpreted on next use. Returns false, leaving
+  // the pattern as it was, if |source| needs a pattern of its own.
+  bool Extend(const AtomicString& source);
+
+  // One KURL per alternative.
+  const Vector<KURL>& Urls();
+  // One parsed value per alternative, nullptr where the alternative does not
+  // parse as a value of |property_id|. Parsing goes through |cache|.
+  const HeapVector<Member<const CSSValue>>& CssValues(CSSPropertyID property_id, const CSSParserContext*, ShadowCSSValueCache& cache);
+  // Whether |value| is a single number within the range that the numeric
+  // alternatives of its unit span.
+  bool NumericRangesContain(const CSSValue& value, CSSPropertyID property_id, const CSSParserContext*, ShadowCSSValueCache& cache);
+  // One token sequence per alternative, for script attributes. |scanner| is
+  // only used for alternatives that were not scanned before.
+  const Vector<ScriptTokenSequence>& ScriptTokens(v8_scanner::ReusableScanner& scanner);
+
+  void Trace(Visitor*) const;
+
+ private:
+  // Splits |source_| from |start| on and appends the parts to |alternatives_|.
+  void AppendAlternatives(wtf_size_t start);
+
+  AtomicString source_;
+  Vector<AtomicString> alternatives_;
+  // Whether |source_| ends in an unpaired '\', which would escape the '|' that
+  // Extend() looks for.
+  bool ends_with_escape_ = false;
+
+  Vector<KURL> urls_;
+
+  bool has_css_values_ = false;
+  CSSPropertyID css_property_id_;
+  Member<const CSSParserContext> css_parser_context_;
+  HeapVector<Member<const CSSValue>> css_values_;
+  // Widened as |css_values_| grows; a property rarely has more than a couple.
+  Vector<CSSNumericRange> numeric_ranges_;
+
+  Vector<ScriptTokenSequence> script_tokens_;
+};
+
+// Rewrites the alternatives of |pattern| into at most |max_alternatives| where
+// possible, for values that record mode keeps seeing new variants of, such as
+// counters, timestamps and session tokens. Literal alternatives that differ
+// only in their runs of digits are folded into one glob, with a '?' for every
+// digit that varies between runs of equal length and a '*' for runs of varying
+// length. If that is not enough, all literal alternatives become a single glob
+// of their common prefix and suffix. The result never gets a bare '*' that
+// would accept any value: literals that have nothing in common are kept, even
+// if that leaves more than |max_alternatives|. Empty and wildcard alternatives
+// are kept, and every alternative of |pattern| still matches the result.
+CORE_EXPORT AtomicString GeneralizeAlternatives(const DOMConstraintPattern& pattern, wtf_size_t max_alternatives);
+
+// The compiled patterns of the monitored and "dtt-*" attributes of a single
+// shadow element, keyed by attribute name. A pattern is recompiled when the
+// shadow attribute no longer holds the value it was compiled from, so record
+// mode merges are picked up without explicit invalidation.
+class CORE_EXPORT ShadowElementPatterns final
+    : public GarbageCollected<ShadowElementPatterns> {
+ public:
+  ShadowElementPatterns() = default;
+
+  DOMConstraintPattern* Get(const AtomicString& attribute_name, const AtomicString& value);
+
+  void Trace(Visitor*) const;
+
+ private:
+  HeapHashMap<AtomicString, Member<DOMConstraintPattern>> patterns_;
+};
+
+}  // namespace blink
+
+#endif  // THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_PATTERN_H_
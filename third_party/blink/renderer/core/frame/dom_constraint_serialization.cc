@@ -0,0 +1,202 @@
+#include "third_party/blink/renderer/core/frame/dom_constraint_serialization.h"
+
+#include <string.h>
+
+#include <string>
+
+#include "third_party/blink/renderer/core/dom/document.h"
+#include "third_party/blink/renderer/core/dom/document_init.h"
+#include "third_party/blink/renderer/core/dom/element.h"
+#include "third_party/blink/renderer/core/dom/qualified_name.h"
+#include "third_party/blink/renderer/platform/heap/heap_allocator.h"
+#include "third_party/blink/renderer/platform/wtf/hash_map.h"
+#include "third_party/blink/renderer/platform/wtf/text/atomic_string.h"
+#include "third_party/blink/renderer/platform/wtf/text/atomic_string_hash.h"
+
+namespace blink {
+
+namespace {
+
+constexpr uint64_t kHeaderFields = 6;
+constexpr uint64_t kStringFields = 2;
+constexpr uint64_t kElementFields = 4;
+constexpr uint64_t kAttributeFields = 4;
+
+class StringTable {
+  STACK_ALLOCATED();
+
+ public:
+  uint32_t Add(const AtomicString& string) {
+    if (string.IsNull()) {
+      return kNoDOMConstraintString;
+    }
+    auto result = indices_.insert(string, strings_.size());
+    if (result.is_new_entry) {
+      strings_.push_back(string);
+    }
+    return result.stored_value->value;
+  }
+
+  const Vector<AtomicString>& Strings() const { return strings_; }
+
+ private:
+  HashMap<AtomicString, uint32_t> indices_;
+  Vector<AtomicString> strings_;
+};
+
+void AppendField(Vector<uint8_t>& data, uint32_t value) {
+  data.Append(reinterpret_cast<const uint8_t*>(&value), sizeof(value));
+}
+
+void AppendFields(Vector<uint8_t>& data, const Vector<uint32_t>& values) {
+  data.Append(reinterpret_cast<const uint8_t*>(values.data()), values.size() * sizeof(uint32_t));
+}
+
+uint32_t ReadField(base::span<const uint8_t> data, uint64_t index) {
+  uint32_t value;
+  memcpy(&value, data.data() + index * sizeof(uint32_t), sizeof(value));
+  return value;
+}
+
+void CollectElements(const Node& node, uint32_t parent, StringTable& strings, Vector<uint32_t>& elements, Vector<uint32_t>& attributes) {
+  for (auto *child = node.firstChild(); child; child = child->nextSibling()) {
+    const Element *element = DynamicTo<Element>(child);
+    if (!element) {
+      continue;
+    }
+    uint32_t index = elements.size() / kElementFields;
+    AttributeCollection element_attributes = element->Attributes();
+    elements.push_back(parent);
+    elements.push_back(strings.Add(AtomicString(element->tagName())));
+    elements.push_back(attributes.size() / kAttributeFields);
+    elements.push_back(element_attributes.size());
+    for (const Attribute& attribute : element_attributes) {
+      attributes.push_back(strings.Add(attribute.GetName().Prefix()));
+      attributes.push_back(strings.Add(attribute.GetName().LocalName()));
+      attributes.push_back(strings.Add(attribute.GetName().NamespaceURI()));
+      attributes.push_back(strings.Add(attribute.Value()));
+    }
+    CollectElements(*element, index, strings, elements, attributes);
+  }
+}
+
+}  // namespace
+
+Vector<uint8_t> SerializeDOMConstraint(const Document& dom_constraint) {
+  StringTable strings;
+  Vector<uint32_t> elements;
+  Vector<uint32_t> attributes;
+  CollectElements(dom_constraint, kNoDOMConstraintString, strings, elements, attributes);
+
+  Vector<uint32_t> string_entries;
+  Vector<uint8_t> string_data;
+  for (const AtomicString& string : strings.Strings()) {
+    std::string utf8 = string.Utf8();
+    string_entries.push_back(string_data.size());
+    string_entries.push_back(utf8.size());
+    string_data.Append(reinterpret_cast<const uint8_t*>(utf8.data()), utf8.size());
+  }
+
+  Vector<uint8_t> data;
+  data.ReserveInitialCapacity((kHeaderFields + string_entries.size() + elements.size() + attributes.size()) * sizeof(uint32_t) + string_data.size());
+  AppendField(data, kDOMConstraintMagic);
+  AppendField(data, kDOMConstraintVersion);
+  AppendField(data, strings.Strings().size());
+  AppendField(data, elements.size() / kElementFields);
+  AppendField(data, attributes.size() / kAttributeFields);
+  AppendField(data, string_data.size());
+  AppendFields(data, string_entries);
+  AppendFields(data, elements);
+  AppendFields(data, attributes);
+  data.AppendVector(string_data);
+  return data;
+}
+
+Document* DeserializeDOMConstraint(base::span<const uint8_t> data) {
+  if (data.size() < kHeaderFields * sizeof(uint32_t) || ReadField(data, 0) != kDOMConstraintMagic || ReadField(data, 1) != kDOMConstraintVersion) {
+    return nullptr;
+  }
+  uint64_t string_count = ReadField(data, 2);
+  uint64_t element_count = ReadField(data, 3);
+  uint64_t attribute_count = ReadField(data, 4);
+  uint64_t string_data_size = ReadField(data, 5);
+  uint64_t strings_begin = kHeaderFields;
+  uint64_t elements_begin = strings_begin + string_count * kStringFields;
+  uint64_t attributes_begin = elements_begin + element_count * kElementFields;
+  uint64_t string_data_begin = (attributes_begin + attribute_count * kAttributeFields) * sizeof(uint32_t);
+  if (string_data_begin + string_data_size != data.size()) {
+    return nullptr;
+  }
+
+  // Every string is interned straight from |data|, once.
+  Vector<AtomicString> strings;
+  strings.ReserveInitialCapacity(string_count);
+  for (uint64_t i = 0; i < string_count; ++i) {
+    uint64_t offset = ReadField(data, strings_begin + i * kStringFields);
+    uint64_t length = ReadField(data, strings_begin + i * kStringFields + 1);
+    if (offset + length > string_data_size) {
+      return nullptr;
+    }
+    AtomicString string = AtomicString::FromUTF8(reinterpret_cast<const char*>(data.data() + string_data_begin + offset), length);
+    if (string.IsNull()) {
+      return nullptr;
+    }
+    strings.push_back(string);
+  }
+  auto string_at = [&strings](uint32_t index, AtomicString& string) {
+    if (index == kNoDOMConstraintString) {
+      string = g_null_atom;
+      return true;
+    }
+    if (index >= strings.size()) {
+      return false;
+    }
+    string = strings[index];
+    return true;
+  };
+
+  Document* doc = DocumentInit::Create()
+                    .WithTypeFrom("text/html")
+                    .CreateDocument();
+  doc->setAllowDeclarativeShadowRoots(false);
+  doc->SetMimeType(AtomicString("text/html"));
+
+  HeapVector<Member<Element>> elements;
+  elements.ReserveInitialCapacity(element_count);
+  for (uint64_t i = 0; i < element_count; ++i) {
+    uint64_t field = elements_begin + i * kElementFields;
+    uint32_t parent = ReadField(data, field);
+    uint64_t first_attribute = ReadField(data, field + 2);
+    uint64_t element_attribute_count = ReadField(data, field + 3);
+    AtomicString tag;
+    if (!string_at(ReadField(data, field + 1), tag) || tag.IsNull() || first_attribute + element_attribute_count > attribute_count) {
+      return nullptr;
+    }
+    // A document holds a single element, and parents always come first.
+    if (parent == kNoDOMConstraintString ? doc->documentElement() != nullptr : parent >= i) {
+      return nullptr;
+    }
+
+    Element *element = doc->CreateRawElement(QualifiedName(g_null_atom, tag, g_null_atom));
+    for (uint64_t j = first_attribute; j < first_attribute + element_attribute_count; ++j) {
+      uint64_t attribute_field = attributes_begin + j * kAttributeFields;
+      AtomicString prefix, local_name, namespace_uri, value;
+      if (!string_at(ReadField(data, attribute_field), prefix) || !string_at(ReadField(data, attribute_field + 1), local_name) ||
+          !string_at(ReadField(data, attribute_field + 2), namespace_uri) || !string_at(ReadField(data, attribute_field + 3), value) ||
+          local_name.IsNull() || value.IsNull()) {
+        return nullptr;
+      }
+      element->setAttribute(QualifiedName(prefix, local_name, namespace_uri), value);
+    }
+
+    if (parent == kNoDOMConstraintString) {
+      doc->appendChild(element);
+    } else {
+      elements[parent]->appendChild(element);
+    }
+    elements.push_back(element);
+  }
+  return doc;
+}
+
+}  // namespace blink
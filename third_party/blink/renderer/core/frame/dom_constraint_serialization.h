@@ -0,0 +1,52 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_SERIALIZATION_H_
+#define THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_SERIALIZATION_H_
+
+#include <stdint.h>
+
+#include "base/containers/span.h"
+#include "third_party/blink/renderer/core/core_export.h"
+#include "third_party/blink/renderer/platform/wtf/vector.h"
+
+namespace blink {
+
+class Document;
+
+// Binary form of a DOM constraint, an alternative to its HTML form that loads
+// without going through the HTML parser or the "dtt-dangling" rearrangement.
+// All fields are uint32_t in host byte order, since the data only ever travels
+// between processes on the same machine:
+//
+//   header      magic "DOMC", version, string count, element count,
+//               attribute count, string data size
+//   strings     (offset, length) of each UTF-8 string in the string data
+//   elements    (parent, tag, first attribute, attribute count), in tree
+//               order, so every parent comes before its children
+//   attributes  (prefix, local name, namespace, value)
+//   string data
+//
+// Strings are referred to by index, with kNoDOMConstraintString for null
+// strings and parents of top-level elements. Every distinct string is stored,
+// and later interned, once. Only elements and their attributes are kept; text
+// and comments never take part in matching.
+//
+// The computed styles of the shadow elements are not part of the format; they
+// are derived from the "dtt-s-*" attributes after loading, exactly as for the
+// HTML form.
+constexpr uint32_t kDOMConstraintMagic = 0x434d4f44;  // "DOMC"
+constexpr uint32_t kDOMConstraintVersion = 1;
+constexpr uint32_t kNoDOMConstraintString = 0xffffffff;
+
+CORE_EXPORT Vector<uint8_t> SerializeDOMConstraint(const Document& dom_constraint);
+
+// Returns a new, unstyled constraint document, or nullptr if |data| is not a
+// well-formed constraint of a supported version. |data| is read in place and
+// may be released as soon as this returns.
+CORE_EXPORT Document* DeserializeDOMConstraint(base::span<const uint8_t> data);
+
+}  // namespace blink
+
+#endif  // THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_SERIALIZATION_H_
@@ -0,0 +1,230 @@
+#include "third_party/blink/renderer/core/frame/dom_constraint_tree.h"
+
+#include "third_party/blink/renderer/core/dom/document.h"
+#include "third_party/blink/renderer/core/dom/element.h"
+#include "third_party/blink/renderer/core/dom/node.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_overlay.h"
+#include "third_party/blink/renderer/platform/wtf/hash_functions.h"
+
+namespace blink {
+
+namespace {
+
+// Salts that keep the tag and attribute name keys apart from the (tag, id) keys.
+constexpr unsigned kTagKeySalt = 1;
+constexpr unsigned kAttributeKeySalt = 2;
+
+ShadowSubtreeSummary::ElementKeys ElementKeysFor(const AtomicString& tag, const AtomicString& id, bool any_id) {
+  unsigned tag_hash = tag.Hash();
+  return {tag, id, WTF::HashInts(kTagKeySalt, tag_hash), WTF::HashInts(tag_hash, id.IsNull() ? 0 : id.Hash()), any_id};
+}
+
+}  // namespace
+
+ShadowSubtreeSummary::ElementKeys ShadowSubtreeSummary::KeysFor(const Element* element, bool any_id) {
+  return ElementKeysFor(DOMConstraintTree::TagKey(element), element->GetIdAttribute(), any_id);
+}
+
+unsigned ShadowSubtreeSummary::AttributeKey(const AtomicString& attribute_name) {
+  // Shadow and live attribute names may differ in case depending on the element's namespace.
+  return WTF::HashInts(kAttributeKeySalt, attribute_name.LowerASCII().Hash());
+}
+
+void ShadowSubtreeSummary::AddElement(const Element* shadow_element) {
+  const AtomicString& id = shadow_element->getAttribute("dtt-id");
+  ElementKeys keys = ElementKeysFor(DOMConstraintTree::TagKey(shadow_element), id, false);
+  Add(keys.tag);
+  if (DOMConstraintTree::IsLiteralId(id)) {
+    Add(keys.tag_and_id);
+  } else {
+    has_wildcard_id_ = true;
+  }
+
+  for (const Attribute& attribute : shadow_element->Attributes()) {
+    // "dtt-*" attributes are internal and never looked for.
+    if (!attribute.LocalName().StartsWith("dtt-")) {
+      Add(AttributeKey(attribute.LocalName()));
+    }
+  }
+}
+
+void ShadowSubtreeSummary::Merge(const ShadowSubtreeSummary& other) {
+  bits_ |= other.bits_;
+  has_wildcard_id_ |= other.has_wildcard_id_;
+}
+
+bool ShadowSubtreeSummary::MayContain(const ElementKeys& keys) const {
+  if (!MayContain(keys.tag)) {
+    return false;
+  }
+  return keys.any_id || has_wildcard_id_ || MayContain(keys.tag_and_id);
+}
+
+void ShadowSubtreeSummary::Add(unsigned key) {
+  bits_.set(key % kBits);
+  bits_.set((key >> 16) % kBits);
+}
+
+bool ShadowSubtreeSummary::MayContain(unsigned key) const {
+  return bits_.test(key % kBits) && bits_.test((key >> 16) % kBits);
+}
+
+DOMConstraintTree::DOMConstraintTree(Document& dom_constraint, const DOMConstraintOverlay& overlay) : overlay_(&overlay) {
+  AddSubtree(&dom_constraint, kNotFound);
+}
+
+bool DOMConstraintTree::IsLiteralId(const AtomicString& id) {
+  if (id.IsNull()) {
+    return true;
+  }
+  // An empty pattern also matches a missing id, so it cannot be hashed.
+  if (id.IsEmpty()) {
+    return false;
+  }
+  wtf_size_t length = id.length();
+  for (wtf_size_t i = 0; i < length; ++i) {
+    UChar c = id[i];
+    if (c == '\\' || c == '|' || c == '*' || c == '?') {
+      return false;
+    }
+  }
+  return true;
+}
+
+AtomicString DOMConstraintTree::TagKey(const Element* element) {
+  return AtomicString(element->tagName());
+}
+
+Element* DOMConstraintTree::GetElement(NodeId id) const {
+  return To<Element>(shadow_nodes_[id].Get());
+}
+
+bool DOMConstraintTree::MayMatch(NodeId id, const ShadowSubtreeSummary::ElementKeys& keys) const {
+  const NodeData& node = nodes_[id];
+  if (node.tag != keys.tag_name) {
+    return false;
+  }
+  return keys.any_id || !node.has_literal_id || node.id == keys.id;
+}
+
+DOMConstraintTree::NodeId DOMConstraintTree::FindLiteralChild(NodeId parent, const AtomicString& tag, const AtomicString& id) const {
+  // An empty live id must not find a child without "dtt-id", and other ids that are not literal cannot equal one.
+  if (!IsLiteralId(id)) {
+    return kNotFound;
+  }
+  auto it = literal_children_.find(MakeChildKey(parent, tag, id));
+  return it == literal_children_.end() ? kNotFound : it->value;
+}
+
+const AtomicString& DOMConstraintTree::Attribute(NodeId id, const AtomicString& name) const {
+  return overlay_->Current(GetElement(id))->getAttribute(name);
+}
+
+DOMConstraintPattern& DOMConstraintTree::Pattern(NodeId id, const AtomicString& name) {
+  if (!patterns_[id]) {
+    patterns_[id] = MakeGarbageCollected<ShadowElementPatterns>();
+  }
+  return *patterns_[id]->Get(name, Attribute(id, name));
+}
+
+DOMConstraintTree::NodeId DOMConstraintTree::DidAppendChild(NodeId parent, Element* shadow_child) {
+  NodeId child = AddSubtree(shadow_child, parent);
+  ShadowSubtreeSummary added = nodes_[child].summary;
+  added.AddElement(shadow_child);
+  MergeIntoAncestors(parent, added);
+  return child;
+}
+
+void DOMConstraintTree::DidChangeAttributes(NodeId id) {
+  const Element *current = overlay_->Current(GetElement(id));
+  // Record mode never changes "dtt-id", so the child keys stay valid.
+  DCHECK(current->getAttribute("dtt-id") == nodes_[id].id);
+  SetElementData(id, current);
+  // New attribute names are simply added; names that went away stay behind as false positives.
+  ShadowSubtreeSummary added;
+  added.AddElement(current);
+  MergeIntoAncestors(nodes_[id].parent, added);
+}
+
+DOMConstraintTree::NodeId DOMConstraintTree::AddSubtree(Node* shadow_node, NodeId parent) {
+  NodeId id = nodes_.size();
+  nodes_.push_back(NodeData());
+  shadow_nodes_.push_back(shadow_node);
+  patterns_.push_back(nullptr);
+  if (auto *shadow_element = DynamicTo<Element>(shadow_node)) {
+    SetElementData(id, shadow_element);
+  }
+
+  if (parent != kNotFound) {
+    nodes_[id].parent = parent;
+    if (nodes_[parent].last_child == kNotFound) {
+      nodes_[parent].first_child = id;
+    } else {
+      nodes_[nodes_[parent].last_child].next_sibling = id;
+    }
+    nodes_[parent].last_child = id;
+    IndexChild(parent, id);
+  }
+
+  // Text and other non-element children never match anything, so they get no record.
+  for (auto *child = shadow_node->firstChild(); child; child = child->nextSibling()) {
+    Element *child_element = DynamicTo<Element>(child);
+    if (!child_element) {
+      continue;
+    }
+    NodeId child_id = AddSubtree(child_element, id);
+    // |nodes_| may have grown, so nothing is held across the recursion.
+    ShadowSubtreeSummary child_summary = nodes_[child_id].summary;
+    child_summary.AddElement(child_element);
+    nodes_[id].summary.Merge(child_summary);
+  }
+  return id;
+}
+
+void DOMConstraintTree::SetElementData(NodeId id, const Element* shadow_element) {
+  NodeData& node = nodes_[id];
+  node.tag = DOMConstraintTree::TagKey(shadow_element);
+  node.id = shadow_element->getAttribute("dtt-id");
+  node.has_literal_id = IsLiteralId(node.id);
+  node.is_whitelisted = shadow_element->getAttribute("dtt-whitelist") != g_null_atom;
+}
+
+const AtomicString& DOMConstraintTree::NullIdKey() {
+  DEFINE_STATIC_LOCAL(const AtomicString, null_id_key, ("|"));
+  return null_id_key;
+}
+
+DOMConstraintTree::ChildKey DOMConstraintTree::MakeChildKey(NodeId parent, const AtomicString& tag, const AtomicString& id) {
+  DCHECK(IsLiteralId(id));
+  return ChildKey(parent, std::make_pair(tag, id.IsNull() ? NullIdKey() : id));
+}
+
+void DOMConstraintTree::IndexChild(NodeId parent, NodeId child) {
+  NodeData& child_node = nodes_[child];
+  if (child_node.has_literal_id) {
+    // `insert` keeps the first child, which is what a scan in tree order would find.
+    literal_children_.insert(MakeChildKey(parent, child_node.tag, child_node.id), child);
+    return;
+  }
+  NodeData& parent_node = nodes_[parent];
+  if (parent_node.last_wildcard_child == kNotFound) {
+    parent_node.first_wildcard_child = child;
+  } else {
+    nodes_[parent_node.last_wildcard_child].next_wildcard_sibling = child;
+  }
+  parent_node.last_wildcard_child = child;
+}
+
+void DOMConstraintTree::MergeIntoAncestors(NodeId id, const ShadowSubtreeSummary& summary) {
+  for (; id != kNotFound; id = nodes_[id].parent) {
+    nodes_[id].summary.Merge(summary);
+  }
+}
+
+void DOMConstraintTree::Trace(Visitor* visitor) const {
+  visitor->Trace(overlay_);
+  visitor->Trace(shadow_nodes_);
+  visitor->Trace(patterns_);
+}
+
+}  // namespace blink
@@ -0,0 +1,177 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_TREE_H_
+#define THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_TREE_H_
+
+#include <bitset>
+#include <utility>
+
+#include "third_party/blink/renderer/core/core_export.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_pattern.h"
+#include "third_party/blink/renderer/platform/heap/handle.h"
+#include "third_party/blink/renderer/platform/wtf/hash_map.h"
+#include "third_party/blink/renderer/platform/wtf/text/atomic_string.h"
+#include "third_party/blink/renderer/platform/wtf/vector.h"
+
+namespace blink {
+
+class Document;
+class DOMConstraintOverlay;
+class Element;
+class Node;
+
+// A Bloom filter over the elements strictly below one shadow node: their tags,
+// their (tag, dtt-id) pairs and the names of their attributes. A miss proves
+// that no shadow descendant can match, so whitelist searches can give up
+// without walking the subtree; a hit still needs the full search. Elements
+// with a non-literal "dtt-id" only contribute their tag, and then every id is
+// treated as a possible match. Bits are only ever added, so growing the shadow
+// tree in record mode just merges the new keys into the ancestors.
+class CORE_EXPORT ShadowSubtreeSummary final {
+  DISALLOW_NEW();
+
+ public:
+  // The filter keys of a live element that is looked for below a shadow node.
+  struct ElementKeys {
+    AtomicString tag_name;
+    AtomicString id;
+    unsigned tag;
+    unsigned tag_and_id;
+    // The id can only be matched by pattern (e.g. through a prefix from the
+    // constraint mode), so only the tag may be checked.
+    bool any_id;
+  };
+
+  static ElementKeys KeysFor(const Element* element, bool any_id);
+  static unsigned AttributeKey(const AtomicString& attribute_name);
+
+  // Adds |shadow_element| itself, not its descendants.
+  void AddElement(const Element* shadow_element);
+  void Merge(const ShadowSubtreeSummary&);
+
+  bool MayContain(const ElementKeys&) const;
+  bool MayContainAttribute(unsigned attribute_key) const { return MayContain(attribute_key); }
+
+ private:
+  static constexpr unsigned kBits = 512;
+
+  void Add(unsigned key);
+  bool MayContain(unsigned key) const;
+
+  std::bitset<kBits> bits_;
+  bool has_wildcard_id_ = false;
+};
+
+// Flat index over a DOM constraint document, built in one pass when the
+// constraint is installed. Every shadow element (and the document itself,
+// which is always kDocumentId) gets a record in one contiguous array, linked
+// by first-child/next-sibling indices and carrying its interned tag, its
+// "dtt-id" and the ShadowSubtreeSummary of everything below it. Children with
+// a literal "dtt-id" are also hashed by (parent, tag, id), and the others are
+// linked in a list of their own per parent.
+//
+// Shadow nodes are referred to by NodeId, which is what ShadowBindings and
+// DOMGuard hold, so there is no map back from Node to NodeId. Attribute values
+// are not copied: they are read from the element that the DOMConstraintOverlay
+// says holds them, and compiled into a DOMConstraintPattern kept per record.
+// The Document stays the source of the attributes and of the ComputedStyle of
+// shadow elements, and it is what record mode grows and what gets exported.
+// Record mode has to report every change through DidAppendChild() and
+// DidChangeAttributes(); children appended through the overlay are indexed
+// exactly like DOM children.
+class CORE_EXPORT DOMConstraintTree final {
+  DISALLOW_NEW();
+
+ public:
+  using NodeId = wtf_size_t;
+
+  static constexpr NodeId kDocumentId = 0;
+
+  // |overlay| is what record mode writes |dom_constraint| through.
+  DOMConstraintTree(Document& dom_constraint, const DOMConstraintOverlay& overlay);
+
+  // Whether a "dtt-id" matches nothing but itself (or, if null, only elements
+  // without an id).
+  static bool IsLiteralId(const AtomicString& id);
+  static AtomicString TagKey(const Element*);
+
+  Node* GetNode(NodeId id) const { return shadow_nodes_[id].Get(); }
+  Element* GetElement(NodeId id) const;
+  NodeId FirstChild(NodeId id) const { return nodes_[id].first_child; }
+  NodeId NextSibling(NodeId id) const { return nodes_[id].next_sibling; }
+  const AtomicString& Tag(NodeId id) const { return nodes_[id].tag; }
+  bool IsWhitelisted(NodeId id) const { return id != kNotFound && nodes_[id].is_whitelisted; }
+  const ShadowSubtreeSummary& Summary(NodeId id) const { return nodes_[id].summary; }
+  // False if the tag or the literal "dtt-id" of |id| rules out every element
+  // with |keys|; true means it still has to be matched.
+  bool MayMatch(NodeId id, const ShadowSubtreeSummary::ElementKeys& keys) const;
+
+  // The first child of |parent| in tree order whose tag is |tag| and whose
+  // "dtt-id" is the literal |id| (null for no "dtt-id"), or kNotFound. An |id|
+  // that is not literal itself, such as the empty id, finds nothing.
+  NodeId FindLiteralChild(NodeId parent, const AtomicString& tag, const AtomicString& id) const;
+  // The children of |id| whose "dtt-id" is not literal, in tree order.
+  NodeId FirstWildcardChild(NodeId id) const { return nodes_[id].first_wildcard_child; }
+  NodeId NextWildcardSibling(NodeId id) const { return nodes_[id].next_wildcard_sibling; }
+
+  // The current value of the attribute |name| of the element |id|, or the null
+  // atom. Like Element::getAttribute(), |name| is lowered for HTML elements.
+  const AtomicString& Attribute(NodeId id, const AtomicString& name) const;
+  // The compiled Attribute(id, name). It is compiled on first use and extended
+  // or recompiled once record mode has changed the value.
+  DOMConstraintPattern& Pattern(NodeId id, const AtomicString& name);
+
+  // Returns the NodeId of |shadow_child|, which was just appended below
+  // |parent|.
+  NodeId DidAppendChild(NodeId parent, Element* shadow_child);
+  void DidChangeAttributes(NodeId id);
+
+  void Trace(Visitor*) const;
+
+ private:
+  // (parent, (tag, "dtt-id")), with NullIdKey() standing in for a missing
+  // "dtt-id".
+  using ChildKey = std::pair<NodeId, std::pair<AtomicString, AtomicString>>;
+
+  struct NodeData {
+    AtomicString tag;
+    AtomicString id;
+    bool has_literal_id = true;
+    bool is_whitelisted = false;
+    NodeId parent = kNotFound;
+    NodeId first_child = kNotFound;
+    NodeId last_child = kNotFound;
+    NodeId next_sibling = kNotFound;
+    NodeId first_wildcard_child = kNotFound;
+    NodeId last_wildcard_child = kNotFound;
+    NodeId next_wildcard_sibling = kNotFound;
+    ShadowSubtreeSummary summary;
+  };
+
+  // The key of a missing "dtt-id". A literal "dtt-id" never contains '|', and
+  // FindLiteralChild() never looks up an id that is not literal, so no real id
+  // can share it.
+  static const AtomicString& NullIdKey();
+  static ChildKey MakeChildKey(NodeId parent, const AtomicString& tag, const AtomicString& id);
+
+  NodeId AddSubtree(Node* shadow_node, NodeId parent);
+  void SetElementData(NodeId id, const Element* shadow_element);
+  // Makes |child|, already linked below |parent|, findable by
+  // FindLiteralChild() or the wildcard child list.
+  void IndexChild(NodeId parent, NodeId child);
+  // Merges |summary| into the summaries of |id| and all of its ancestors.
+  void MergeIntoAncestors(NodeId id, const ShadowSubtreeSummary& summary);
+
+  Member<const DOMConstraintOverlay> overlay_;
+  Vector<NodeData> nodes_;
+  HashMap<ChildKey, NodeId> literal_children_;
+  HeapVector<Member<Node>> shadow_nodes_;
+  // Indexed like |nodes_|; nullptr until an attribute of the node is compiled.
+  HeapVector<Member<ShadowElementPatterns>> patterns_;
+};
+
+}  // namespace blink
+
+#endif  // THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_CONSTRAINT_TREE_H_
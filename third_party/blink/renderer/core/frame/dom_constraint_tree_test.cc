@@ -0,0 +1,64 @@
+#include "third_party/blink/renderer/core/frame/dom_constraint_tree.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/blink/renderer/core/dom/element.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_index.h"
+#include "third_party/blink/renderer/core/html/html_element.h"
+#include "third_party/blink/renderer/core/testing/page_test_base.h"
+
+namespace blink {
+
+class DOMConstraintTreeTest : public PageTestBase {
+ protected:
+  // The tree mirrors GetDocument(): the document, then <html>, <head> and
+  // <body>.
+  static DOMConstraintTree::NodeId Body(const DOMConstraintTree& tree) {
+    DOMConstraintTree::NodeId html = tree.FirstChild(DOMConstraintTree::kDocumentId);
+    return tree.NextSibling(tree.FirstChild(html));
+  }
+};
+
+TEST_F(DOMConstraintTreeTest, FindLiteralChild) {
+  SetBodyInnerHTML("<div></div><div dtt-id='a'></div><div dtt-id='a'></div>");
+  auto *index = MakeGarbageCollected<DOMConstraintIndex>(GetDocument(), false);
+  DOMConstraintTree& tree = index->Tree();
+  DOMConstraintTree::NodeId body = Body(tree);
+  DOMConstraintTree::NodeId first = tree.FirstChild(body);
+  DOMConstraintTree::NodeId second = tree.NextSibling(first);
+
+  EXPECT_EQ(first, tree.FindLiteralChild(body, "DIV", g_null_atom));
+  // The first of several equal children wins.
+  EXPECT_EQ(second, tree.FindLiteralChild(body, "DIV", "a"));
+  EXPECT_EQ(kNotFound, tree.FindLiteralChild(body, "DIV", "b"));
+  EXPECT_EQ(kNotFound, tree.FindLiteralChild(body, "SPAN", g_null_atom));
+}
+
+TEST_F(DOMConstraintTreeTest, EmptyIdDoesNotFindChildWithoutDttId) {
+  SetBodyInnerHTML("<div></div><div dtt-id='a'></div>");
+  auto *index = MakeGarbageCollected<DOMConstraintIndex>(GetDocument(), false);
+  DOMConstraintTree& tree = index->Tree();
+  DOMConstraintTree::NodeId body = Body(tree);
+
+  // A live element with id="" must not pair with the id-less sibling, just as
+  // an attribute with a null shadow pattern only accepts a null value.
+  EXPECT_EQ(kNotFound, tree.FindLiteralChild(body, "DIV", g_empty_atom));
+  EXPECT_EQ(kNotFound, tree.FindLiteralChild(body, "DIV", "|"));
+}
+
+TEST_F(DOMConstraintTreeTest, EmptyDttIdIsAWildcardChild) {
+  SetBodyInnerHTML("<div dtt-id=''></div><div dtt-id='a*'></div><div dtt-id='b'></div>");
+  auto *index = MakeGarbageCollected<DOMConstraintIndex>(GetDocument(), false);
+  DOMConstraintTree& tree = index->Tree();
+  DOMConstraintTree::NodeId body = Body(tree);
+  DOMConstraintTree::NodeId first = tree.FirstChild(body);
+  DOMConstraintTree::NodeId second = tree.NextSibling(first);
+
+  EXPECT_EQ(kNotFound, tree.FindLiteralChild(body, "DIV", g_empty_atom));
+  DOMConstraintTree::NodeId wildcard = tree.FirstWildcardChild(body);
+  EXPECT_EQ(first, wildcard);
+  EXPECT_EQ(second, tree.NextWildcardSibling(wildcard));
+  EXPECT_EQ(kNotFound, tree.NextWildcardSibling(tree.NextWildcardSibling(wildcard)));
+  EXPECT_EQ(GetDocument().body()->firstElementChild(), tree.GetElement(first));
+}
+
+}  // namespace blink
@@ -1,5 +1,9 @@
 #include "third_party/blink/renderer/core/frame/dom_guard.h"
 
+#include <string.h>
+
+#include "base/bits.h"
+#include "build/build_config.h"
 #include "third_party/blink/renderer/core/core_probe_sink.h"
 #include "third_party/blink/renderer/core/css/css_image_value.h"
 #include "third_party/blink/renderer/core/css/css_primitive_value.h"
@@ -17,6 +21,9 @@
 #include "third_party/blink/renderer/core/dom/node_computed_style.h"
 #include "third_party/blink/renderer/core/dom/text.h"
 #include "third_party/blink/renderer/core/editing/serializers/serialization.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_config.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_index.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_pattern.h"
 #include "third_party/blink/renderer/core/frame/local_dom_window.h"
 #include "third_party/blink/renderer/core/frame/local_frame.h"
 #include "third_party/blink/renderer/core/frame/v8_scanner/scanner.h"
@@ -25,101 +32,236 @@
 #include "third_party/blink/renderer/core/html/parser/html_document_parser.h"
 #include "third_party/blink/renderer/core/html/parser/html_tree_builder.h"
 #include "third_party/blink/renderer/core/probe/core_probes.h"
+#include "third_party/blink/renderer/core/style/computed_style.h"
 #include "third_party/blink/renderer/core/trustedtypes/trusted_types_util.h"
 
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
 namespace blink {
 
-bool DOMGuard::stringEquals(const String& shadow_string, wtf_size_t shadow_start_position, const String& actual_string, wtf_size_t actual_start_position) {
-  wtf_size_t shadow_ptr = shadow_start_position;
-  wtf_size_t actual_ptr = actual_start_position;
-  bool is_escaped_character = false;
-  while (true) {
-    if (shadow_ptr == shadow_string.length()) {
-      return actual_ptr == actual_string.length();
-    } else if (actual_ptr == actual_string.length()) {
-      return shadow_string[shadow_ptr] == '*' && shadow_ptr == shadow_string.length() - 1;
-    }
-
-    bool ignore_control_character = false;
-    if (is_escaped_character) {
-      ignore_control_character = true;
-      is_escaped_character = false;
-    } else {
-      if (shadow_string[shadow_ptr] == '\\') {
-        is_escaped_character = true;
-        shadow_ptr += 1;
-        continue;
-      } else if (shadow_string[shadow_ptr] == '*') {
-        return stringEquals(shadow_string, shadow_ptr + 1, actual_string, actual_ptr) || stringEquals(shadow_string, shadow_ptr, actual_string, actual_ptr + 1);
-      }
-    }
+namespace {
 
-    if (shadow_string[shadow_ptr] == actual_string[actual_ptr] || (shadow_string[shadow_ptr] == '?' && !ignore_control_character)) {
-      shadow_ptr += 1;
-      actual_ptr += 1;
-    } else {
+// Record mode generalizes a shadow value into globs once it holds more alternatives than this.
+constexpr wtf_size_t kMaxRecordedAlternatives = 64;
+
+inline bool IsWildcardControlCharacter(UChar c) {
+  return c == '*' || c == '?' || c == '\\';
+}
+
+// Length of the run of plain characters in |shadow| starting at |from|.
+template <typename CharType>
+wtf_size_t LiteralRunLength(const CharType* shadow, wtf_size_t from, wtf_size_t length) {
+  wtf_size_t end = from;
+  while (end < length && !IsWildcardControlCharacter(shadow[end])) {
+    end += 1;
+  }
+  return end - from;
+}
+
+inline bool EqualCharacters(const LChar* a, const LChar* b, wtf_size_t length) {
+  return !memcmp(a, b, length);
+}
+
+inline bool EqualCharacters(const UChar* a, const UChar* b, wtf_size_t length) {
+  return !memcmp(a, b, length * sizeof(UChar));
+}
+
+inline bool EqualCharacters(const LChar* a, const UChar* b, wtf_size_t length) {
+  wtf_size_t i = 0;
+#if defined(ARCH_CPU_X86_FAMILY)
+  // Widen 16 LChars at a time and compare them against two 8-UChar loads.
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= length; i += 16) {
+    __m128i narrow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 8));
+    __m128i equal = _mm_and_si128(_mm_cmpeq_epi16(_mm_unpacklo_epi8(narrow, zero), low), _mm_cmpeq_epi16(_mm_unpackhi_epi8(narrow, zero), high));
+    if (_mm_movemask_epi8(equal) != 0xFFFF) {
       return false;
     }
   }
+#endif
+  for (; i < length; ++i) {
+    if (a[i] != b[i]) {
+      return false;
+    }
+  }
+  return true;
 }
 
-bool DOMGuard::stringEquals(const AtomicString& shadow_string, wtf_size_t shadow_start_position, const AtomicString& actual_string, wtf_size_t actual_start_position) {
-  return stringEquals(shadow_string.GetString(), shadow_start_position, actual_string.GetString(), actual_start_position);
+inline bool EqualCharacters(const UChar* a, const LChar* b, wtf_size_t length) {
+  return EqualCharacters(b, a, length);
 }
 
-bool DOMGuard::scriptEquals(const String& shadow_string, const String& actual_string) {
-  uint16_t shadow_16[shadow_string.length() + 1];
-  if (shadow_string.Is8Bit()) {
-    for (unsigned int i = 0; i < shadow_string.length(); ++i) {
-      shadow_16[i] = shadow_string.Characters8()[i];
+// Index of the first |c| in |characters| at or after |index|, or kNotFound.
+inline wtf_size_t FindCharacter(const LChar* characters, wtf_size_t length, UChar c, wtf_size_t index) {
+  if (c > 0xFF || index >= length) {
+    return kNotFound;
+  }
+  const void* found = memchr(characters + index, c, length - index);
+  return found ? static_cast<wtf_size_t>(static_cast<const LChar*>(found) - characters) : kNotFound;
+}
+
+inline wtf_size_t FindCharacter(const UChar* characters, wtf_size_t length, UChar c, wtf_size_t index) {
+#if defined(ARCH_CPU_X86_FAMILY)
+  const __m128i needle = _mm_set1_epi16(c);
+  for (; index + 8 <= length; index += 8) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(characters + index));
+    uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi16(chunk, needle));
+    if (mask) {
+      return index + (base::bits::CountTrailingZeroBits(mask) >> 1);
     }
-  } else {
-    for (unsigned int i = 0; i < shadow_string.length(); ++i) {
-      shadow_16[i] = shadow_string.Characters16()[i];
+  }
+#endif
+  for (; index < length; ++index) {
+    if (characters[index] == c) {
+      return index;
     }
   }
-  shadow_16[shadow_string.length()] = 0;
-  std::unique_ptr<::v8_scanner::Utf16CharacterStream> shadow_stream = ::v8_scanner::ScannerStream::ForTesting(shadow_16, shadow_string.length());
-  std::unique_ptr<::v8_scanner::Scanner> shadow_scanner = std::unique_ptr<::v8_scanner::Scanner>(new ::v8_scanner::Scanner(shadow_stream.get()));
-  shadow_scanner->Initialize();
+  return kNotFound;
+}
 
-  uint16_t actual_16[actual_string.length() + 1];
-  if (actual_string.Is8Bit()) {
-    for (unsigned int i = 0; i < actual_string.length(); ++i) {
-      actual_16[i] = actual_string.Characters8()[i];
+// After a '*', no attempt can succeed before the next occurrence of the literal character that follows it, so move
+// |actual_ptr| there. Returns false if that character does not occur at all.
+template <typename ShadowCharType, typename ActualCharType>
+bool SkipToLiteralAfterStar(const ShadowCharType* shadow, wtf_size_t shadow_ptr, wtf_size_t shadow_length, const ActualCharType* actual, wtf_size_t actual_length, wtf_size_t& actual_ptr) {
+  if (shadow_ptr == shadow_length || shadow[shadow_ptr] == '*' || shadow[shadow_ptr] == '?') {
+    return true;
+  }
+  UChar literal = shadow[shadow_ptr];
+  if (literal == '\\') {
+    if (shadow_ptr + 1 == shadow_length) {
+      return true;
     }
-  } else {
-    for (unsigned int i = 0; i < actual_string.length(); ++i) {
-      actual_16[i] = actual_string.Characters16()[i];
+    literal = shadow[shadow_ptr + 1];
+  }
+  actual_ptr = FindCharacter(actual, actual_length, literal, actual_ptr);
+  return actual_ptr != kNotFound;
+}
+
+// Matches |actual| against the glob |shadow|: '*' matches any run of
+// characters, '?' any single character and a backslash makes the next
+// character literal. Only the most recent '*' is remembered and retried one
+// character further on a mismatch, so the work is bounded by
+// O(shadow_length * actual_length) and the stack depth is constant. Runs of
+// plain characters are compared in one go, and after a '*' the search jumps
+// straight to the next candidate position of the following literal.
+template <typename ShadowCharType, typename ActualCharType>
+bool WildcardMatch(const ShadowCharType* shadow, wtf_size_t shadow_length, const ActualCharType* actual, wtf_size_t actual_length) {
+  wtf_size_t shadow_ptr = 0;
+  wtf_size_t actual_ptr = 0;
+  wtf_size_t star_shadow_ptr = kNotFound;
+  wtf_size_t star_actual_ptr = 0;
+  while (actual_ptr < actual_length) {
+    if (shadow_ptr < shadow_length) {
+      if (shadow[shadow_ptr] == '*') {
+        star_shadow_ptr = shadow_ptr;
+        star_actual_ptr = actual_ptr;
+        shadow_ptr += 1;
+        if (!SkipToLiteralAfterStar(shadow, shadow_ptr, shadow_length, actual, actual_length, star_actual_ptr)) {
+          return false;
+        }
+        actual_ptr = star_actual_ptr;
+        continue;
+      }
+      if (shadow[shadow_ptr] == '\\') {
+        // A trailing backslash escapes nothing and never matches.
+        if (shadow_ptr + 1 < shadow_length && shadow[shadow_ptr + 1] == actual[actual_ptr]) {
+          shadow_ptr += 2;
+          actual_ptr += 1;
+          continue;
+        }
+      } else if (shadow[shadow_ptr] == '?') {
+        shadow_ptr += 1;
+        actual_ptr += 1;
+        continue;
+      } else {
+        wtf_size_t run_length = LiteralRunLength(shadow, shadow_ptr, shadow_length);
+        if (actual_length - actual_ptr < run_length) {
+          // Retrying the last star only leaves less of `actual`, so the run can never fit.
+          return false;
+        }
+        if (EqualCharacters(shadow + shadow_ptr, actual + actual_ptr, run_length)) {
+          shadow_ptr += run_length;
+          actual_ptr += run_length;
+          continue;
+        }
+      }
+    }
+    if (star_shadow_ptr == kNotFound) {
+      return false;
+    }
+    shadow_ptr = star_shadow_ptr + 1;
+    star_actual_ptr += 1;
+    if (!SkipToLiteralAfterStar(shadow, shadow_ptr, shadow_length, actual, actual_length, star_actual_ptr)) {
+      return false;
     }
+    actual_ptr = star_actual_ptr;
   }
-  actual_16[actual_string.length()] = 0;
-  std::unique_ptr<::v8_scanner::Utf16CharacterStream> actual_stream = ::v8_scanner::ScannerStream::ForTesting(actual_16, actual_string.length());
-  std::unique_ptr<::v8_scanner::Scanner> actual_scanner = std::unique_ptr<::v8_scanner::Scanner>(new ::v8_scanner::Scanner(actual_stream.get()));
-  actual_scanner->Initialize();
+  // Once `actual` is used up, only an empty rest or a single trailing '*' is accepted. This keeps the behaviour of the
+  // former recursive matcher, where a trailing "**" needs at least one character.
+  return shadow_ptr == shadow_length || (shadow_ptr + 1 == shadow_length && shadow[shadow_ptr] == '*');
+}
+
+template <typename ShadowCharType>
+bool WildcardMatch(const ShadowCharType* shadow, wtf_size_t shadow_length, const String& actual_string, wtf_size_t actual_start_position) {
+  wtf_size_t actual_length = actual_string.length() - actual_start_position;
+  if (actual_length == 0) {
+    return WildcardMatch(shadow, shadow_length, static_cast<const LChar*>(nullptr), 0);
+  } else if (actual_string.Is8Bit()) {
+    return WildcardMatch(shadow, shadow_length, actual_string.Characters8() + actual_start_position, actual_length);
+  } else {
+    return WildcardMatch(shadow, shadow_length, actual_string.Characters16() + actual_start_position, actual_length);
+  }
+}
+
+}  // namespace
+
+bool DOMGuard::stringEquals(const String& shadow_string, wtf_size_t shadow_start_position, const String& actual_string, wtf_size_t actual_start_position) {
+  wtf_size_t shadow_length = shadow_string.length() - shadow_start_position;
+  if (shadow_length == 0) {
+    return actual_string.length() == actual_start_position;
+  } else if (shadow_string.Is8Bit()) {
+    return WildcardMatch(shadow_string.Characters8() + shadow_start_position, shadow_length, actual_string, actual_start_position);
+  } else {
+    return WildcardMatch(shadow_string.Characters16() + shadow_start_position, shadow_length, actual_string, actual_start_position);
+  }
+}
+
+bool DOMGuard::stringEquals(const AtomicString& shadow_string, wtf_size_t shadow_start_position, const AtomicString& actual_string, wtf_size_t actual_start_position) {
+  return stringEquals(shadow_string.GetString(), shadow_start_position, actual_string.GetString(), actual_start_position);
+}
+
+::v8_scanner::ReusableScanner& DOMGuard::scriptScanner(std::unique_ptr<::v8_scanner::ReusableScanner>& scanner) {
+  if (!scanner) {
+    scanner = std::make_unique<::v8_scanner::ReusableScanner>();
+  }
+  return *scanner;
+}
+
+bool DOMGuard::scriptEquals(const String& shadow_string, const String& actual_string) {
+  // Both scanners read the strings' own storage, so the strings must stay alive until the comparison is done.
+  ::v8_scanner::Scanner& shadow_scanner = ResetScriptScanner(scriptScanner(shadow_script_scanner_), shadow_string);
+  ::v8_scanner::Scanner& actual_scanner = ResetScriptScanner(scriptScanner(actual_script_scanner_), actual_string);
 
   do {
-    if (shadow_scanner->Next() != actual_scanner->Next()) {
+    if (shadow_scanner.Next() != actual_scanner.Next()) {
       return false;
     }
-  } while (shadow_scanner->current_token() != ::v8_scanner::Token::EOS && shadow_scanner->current_token() != ::v8_scanner::Token::ILLEGAL 
-            && actual_scanner->current_token() != ::v8_scanner::Token::EOS && actual_scanner->current_token() != ::v8_scanner::Token::ILLEGAL);
+  } while (shadow_scanner.current_token() != ::v8_scanner::Token::EOS && shadow_scanner.current_token() != ::v8_scanner::Token::ILLEGAL 
+            && actual_scanner.current_token() != ::v8_scanner::Token::EOS && actual_scanner.current_token() != ::v8_scanner::Token::ILLEGAL);
   return true;
 }
 
-bool DOMGuard::idEquals(const AtomicString& shadow_string, const AtomicString& actual_string, const String& dom_constraint_mode) {
-  bool prefix_match = false;
-  if (dom_constraint_mode.length() > 1) {
-    Vector<String> prefixes;
-    dom_constraint_mode.Substring(1).Split(" ", false, prefixes);
-    for (const String& prefix : prefixes) {
-      if (shadow_string.StartsWith(prefix) && actual_string.StartsWith(prefix)) {
-        prefix_match = true;
-        break;
-      }
-    }
-  }
-  return prefix_match || stringEquals(shadow_string, 0, actual_string, 0);
+bool DOMGuard::idEquals(const AtomicString& shadow_string, const AtomicString& actual_string, const DOMConstraintConfig& dom_constraint_config) {
+  return dom_constraint_config.ShareIdPrefix(shadow_string, actual_string) || stringEquals(shadow_string, 0, actual_string, 0);
+}
+
+const DOMConstraintConfig& DOMGuard::constraintConfig(const Node* node) {
+  LocalFrame *frame = node->GetDocument().GetFrame();
+  return frame ? frame->GetDOMConstraintConfig() : DOMConstraintConfig::Detached();
 }
 
 bool DOMGuard::urlEquals(const KURL& url_constraint, const KURL& new_url) {
@@ -179,187 +321,166 @@ bool DOMGuard::isURLAttribute(const Element* element, const AtomicString& attrib
 }
 
 bool DOMGuard::attributeEquals(Element *element, const AtomicString& attribute_name, const AtomicString& shadow_attribute_value, const AtomicString& attribute_value) {
+  // Values that are not stored on a shadow element (e.g. while merging in record mode) are compiled on the spot.
+  return attributeEquals(element, attribute_name, *MakeGarbageCollected<DOMConstraintPattern>(shadow_attribute_value), attribute_value);
+}
+
+bool DOMGuard::attributeEquals(Element *element, const AtomicString& attribute_name, DOMConstraintPattern& shadow_pattern, const AtomicString& attribute_value) {
   // TODO: should we consider `g_null_atom` equal to `g_empty_atom`?
-  if (shadow_attribute_value == g_null_atom) {
+  if (shadow_pattern.IsNull()) {
     return attribute_value == g_null_atom;
   }
-  wtf_size_t shadow_attribute_value_length = shadow_attribute_value.length();
-  bool found_in_shadow_attribute_value = false;
-  bool is_escaped_character = false;
-  StringBuilder unescaped_current_part_builder;
-  
-  Vector<KURL> url_constraints;
 
-  String dom_constraint_mode = element->GetDocument().GetFrame() ? element->GetDocument().GetFrame()->DOMConstraintMode() : "r";
-
-  for (wtf_size_t i = 0; i < shadow_attribute_value_length; ++i) {
-    if (is_escaped_character) {
-      is_escaped_character = false;
-      unescaped_current_part_builder.Append(shadow_attribute_value[i]);
-    } else {
-      if (shadow_attribute_value[i] == '\\') {
-        is_escaped_character = true;
-      } else if (shadow_attribute_value[i] == '|') {
-        if (attribute_name == "dtt-id" || attribute_name == "id") {
-          if (idEquals(unescaped_current_part_builder.ToAtomicString(), attribute_value, dom_constraint_mode)) {
-            found_in_shadow_attribute_value = true;
-            break;
-          }
-        } else if (isScriptAttribute(element, attribute_name)) {
-          if (scriptEquals(unescaped_current_part_builder.ToString(), attribute_value)) {
-            found_in_shadow_attribute_value = true;
-            break;
-          }
-        } else if (isURLAttribute(element, attribute_name)) {
-          url_constraints.push_back(KURL(unescaped_current_part_builder.ToString()));
-        } else if (stringEquals(unescaped_current_part_builder.ToAtomicString(), 0, attribute_value, 0)) {
-          found_in_shadow_attribute_value = true;
-          break;
-        }
-        unescaped_current_part_builder.Clear();
-      } else {
-        unescaped_current_part_builder.Append(shadow_attribute_value[i]);
+  if (attribute_name == "dtt-id" || attribute_name == "id") {
+    const DOMConstraintConfig& dom_constraint_config = constraintConfig(element);
+    for (const AtomicString& alternative : shadow_pattern.Alternatives()) {
+      if (idEquals(alternative, attribute_value, dom_constraint_config)) {
+        return true;
       }
     }
-  }
-  if (attribute_name == "dtt-id" || attribute_name == "id") {
-    return found_in_shadow_attribute_value || idEquals(unescaped_current_part_builder.ToAtomicString(), attribute_value, dom_constraint_mode);
+    return false;
   } else if (isScriptAttribute(element, attribute_name)) {
-    return found_in_shadow_attribute_value || scriptEquals(unescaped_current_part_builder.ToString(), attribute_value);
+    // The handler is lexed once and then checked against every alternative's pre-lexed tokens.
+    const Vector<ScriptTokenSequence>& shadow_script_tokens = shadow_pattern.ScriptTokens(scriptScanner(shadow_script_scanner_));
+    actual_script_tokens_.Assign(scriptScanner(actual_script_scanner_), attribute_value);
+    for (const ScriptTokenSequence& alternative_tokens : shadow_script_tokens) {
+      if (alternative_tokens.Equals(actual_script_tokens_)) {
+        return true;
+      }
+    }
+    return false;
   } else if (isURLAttribute(element, attribute_name)) {
-    url_constraints.push_back(KURL(unescaped_current_part_builder.ToString()));
-    return urlEquals(url_constraints, KURL(attribute_value));
+    return urlEquals(shadow_pattern.Urls(), KURL(attribute_value));
   } else {
-    return found_in_shadow_attribute_value || stringEquals(unescaped_current_part_builder.ToAtomicString(), 0, attribute_value, 0);
-  }
-}
-
-void DOMGuard::cssValueEquals(const CSSProperty& property, const CSSValue* shadow_css_value, const CSSValue* actual_css_value, const CSSParserContext* parser_context, int& match_state) {
-  if (shadow_css_value->GetClassType() == actual_css_value->GetClassType()) {
-    if (shadow_css_value->IsValueList()) {
-      const CSSValueList *shadow_css_value_list = DynamicTo<CSSValueList>(shadow_css_value);
-      const CSSValueList *actual_css_value_list = DynamicTo<CSSValueList>(actual_css_value);
-      if (shadow_css_value_list->value_list_separator_ != actual_css_value->value_list_separator_) {
-        return;
-      }
-      if (shadow_css_value_list->length() != actual_css_value_list->length()) {
-        return;
-      }
-      for (wtf_size_t i = 0; i < shadow_css_value_list->length(); ++i) {
-        cssValueEquals(property, &shadow_css_value_list->Item(i), &actual_css_value_list->Item(i), parser_context, match_state);
-        if (match_state != -1) {
-          return;
-        }
-      }
-      match_state = -1;
-    } else if (shadow_css_value->IsNumericLiteralValue()) {
-      const CSSNumericLiteralValue *shadow_css_numeric_literal_value = DynamicTo<CSSNumericLiteralValue>(shadow_css_value);
-      const CSSNumericLiteralValue *actual_css_numeric_literal_value = DynamicTo<CSSNumericLiteralValue>(actual_css_value);
-      if (shadow_css_numeric_literal_value->DoubleValue() == actual_css_numeric_literal_value->DoubleValue()) {
-        match_state = -1;
-      } else if (shadow_css_numeric_literal_value->DoubleValue() > actual_css_numeric_literal_value->DoubleValue()) {
-        if (match_state == 0) {
-          match_state = 1;
-        } else if (match_state == 2) {
-          match_state = -1;
-        }
-      } else {
-        if (match_state == 0) {
-          match_state = 2;
-        } else if (match_state == 1) {
-          match_state = -1;
-        }
-      }
-    } else if (shadow_css_value->IsURIValue()) {
-      const cssvalue::CSSURIValue *shadow_css_uri_value = DynamicTo<cssvalue::CSSURIValue>(shadow_css_value);
-      const cssvalue::CSSURIValue *actual_css_uri_value = DynamicTo<cssvalue::CSSURIValue>(actual_css_value);
-      if (urlEquals(shadow_css_uri_value->AbsoluteUrl(), actual_css_uri_value->AbsoluteUrl())) {
-        match_state = -1;
-      }
-    } else if (shadow_css_value->IsImageValue()) {
-      const CSSImageValue *shadow_css_image_value = DynamicTo<CSSImageValue>(shadow_css_value);
-      const CSSImageValue *actual_css_image_value = DynamicTo<CSSImageValue>(actual_css_value);
-      if (urlEquals(KURL(shadow_css_image_value->Url()), KURL(actual_css_image_value->Url()))) {
-        match_state = -1;
-      }
-    } else if (shadow_css_value->IsColorValue()) {
-      if (actual_css_value->IsColorValue()) {
-        match_state = -1;
+    for (const AtomicString& alternative : shadow_pattern.Alternatives()) {
+      if (stringEquals(alternative, 0, attribute_value, 0)) {
+        return true;
       }
     }
+    return false;
   }
 }
 
-void DOMGuard::cssValueEquals(const CSSProperty& property, const String& shadow_css_text, const CSSValue* actual_css_value, const CSSParserContext* parser_context, int& match_state) {
-  if (shadow_css_text.length() == 0) {
-    if (actual_css_value == nullptr) {
-      match_state = -1;
-    }
-    return;
-  }
-  if (actual_css_value == nullptr) {
-    match_state = 0;
-    return;
+// Single numbers are checked against DOMConstraintPattern::NumericRangesContain() instead; here they have to be equal,
+// as items of a list.
+bool DOMGuard::cssValueEquals(const CSSProperty& property, const CSSValue* shadow_css_value, const CSSValue* actual_css_value, const CSSParserContext* parser_context) {
+  if (shadow_css_value->GetClassType() != actual_css_value->GetClassType()) {
+    return false;
   }
-
-  if (stringEquals(shadow_css_text, 0, actual_css_value->CssText(), 0)) {
-    match_state = -1;
-  } else {
-    const CSSValue *shadow_css_value = CSSParser::ParseSingleValue(property.PropertyID(), shadow_css_text, parser_context);
-    if (shadow_css_value) {
-      cssValueEquals(property, shadow_css_value, actual_css_value, parser_context, match_state);
+  if (shadow_css_value->IsValueList()) {
+    const CSSValueList *shadow_css_value_list = DynamicTo<CSSValueList>(shadow_css_value);
+    const CSSValueList *actual_css_value_list = DynamicTo<CSSValueList>(actual_css_value);
+    if (shadow_css_value_list->value_list_separator_ != actual_css_value->value_list_separator_) {
+      return false;
+    }
+    if (shadow_css_value_list->length() != actual_css_value_list->length()) {
+      return false;
+    }
+    for (wtf_size_t i = 0; i < shadow_css_value_list->length(); ++i) {
+      if (!cssValueEquals(property, &shadow_css_value_list->Item(i), &actual_css_value_list->Item(i), parser_context)) {
+        return false;
+      }
     }
+    return true;
+  } else if (shadow_css_value->IsNumericLiteralValue()) {
+    const CSSNumericLiteralValue *shadow_css_numeric_literal_value = DynamicTo<CSSNumericLiteralValue>(shadow_css_value);
+    const CSSNumericLiteralValue *actual_css_numeric_literal_value = DynamicTo<CSSNumericLiteralValue>(actual_css_value);
+    return shadow_css_numeric_literal_value->GetType() == actual_css_numeric_literal_value->GetType() && shadow_css_numeric_literal_value->DoubleValue() == actual_css_numeric_literal_value->DoubleValue();
+  } else if (shadow_css_value->IsURIValue()) {
+    const cssvalue::CSSURIValue *shadow_css_uri_value = DynamicTo<cssvalue::CSSURIValue>(shadow_css_value);
+    const cssvalue::CSSURIValue *actual_css_uri_value = DynamicTo<cssvalue::CSSURIValue>(actual_css_value);
+    return urlEquals(shadow_css_uri_value->AbsoluteUrl(), actual_css_uri_value->AbsoluteUrl());
+  } else if (shadow_css_value->IsImageValue()) {
+    const CSSImageValue *shadow_css_image_value = DynamicTo<CSSImageValue>(shadow_css_value);
+    const CSSImageValue *actual_css_image_value = DynamicTo<CSSImageValue>(actual_css_value);
+    return urlEquals(KURL(shadow_css_image_value->Url()), KURL(actual_css_image_value->Url()));
+  } else if (shadow_css_value->IsColorValue()) {
+    return actual_css_value->IsColorValue();
   }
+  return false;
 }
 
-bool DOMGuard::propertyEquals(Element *element, const CSSProperty& property, const AtomicString& current_value, const CSSValue* new_value, const CSSParserContext* parser_context) {
-  if (current_value == g_null_atom) {
+// |element| is the live element being checked; the constraint of its frame caches the parsed alternatives.
+bool DOMGuard::propertyEquals(Element *element, const CSSProperty& property, DOMConstraintPattern& current_pattern, const CSSValue* new_value, const CSSParserContext* parser_context) {
+  if (current_pattern.IsNull()) {
     return new_value == nullptr;
   }
-  wtf_size_t current_value_length = current_value.length();
-  bool is_escaped_character = false;
-  StringBuilder unescaped_current_part_builder;
-  int match_state = 0;
-  for (wtf_size_t i = 0; i < current_value_length; ++i) {
-    if (is_escaped_character) {
-      is_escaped_character = false;
-      unescaped_current_part_builder.Append(current_value[i]);
-    } else {
-      if (current_value[i] == '\\') {
-        is_escaped_character = true;
-      } else if (current_value[i] == '|') {
-        cssValueEquals(property, unescaped_current_part_builder.ToString(), new_value, parser_context, match_state);
-        if (match_state == -1) {
-          return true;
-        }
-        unescaped_current_part_builder.Clear();
-      } else {
-        unescaped_current_part_builder.Append(current_value[i]);
+
+  ShadowCSSValueCache& css_value_cache = element->GetDocument().GetFrame()->GetDOMConstraintIndex()->CSSValueCache();
+  // A single number only needs the range recorded for its unit, which spans every numeric alternative.
+  if (new_value && current_pattern.NumericRangesContain(*new_value, property.PropertyID(), parser_context, css_value_cache)) {
+    return true;
+  }
+
+  const Vector<AtomicString>& shadow_css_texts = current_pattern.Alternatives();
+  const HeapVector<Member<const CSSValue>>& shadow_css_values = current_pattern.CssValues(property.PropertyID(), parser_context, css_value_cache);
+  String new_css_text = new_value ? new_value->CssText() : String();
+  for (wtf_size_t i = 0; i < shadow_css_texts.size(); ++i) {
+    if (shadow_css_texts[i].length() == 0) {
+      if (new_value == nullptr) {
+        return true;
       }
+      continue;
+    }
+    if (new_value == nullptr) {
+      continue;
     }
-  }
 
-  cssValueEquals(property, unescaped_current_part_builder.ToString(), new_value, parser_context, match_state);
-  if (match_state == -1) {
-    return true;
-  } else {
-    return false;
+    if (stringEquals(shadow_css_texts[i].GetString(), 0, new_css_text, 0)) {
+      return true;
+    }
+    if (shadow_css_values[i] && cssValueEquals(property, shadow_css_values[i], new_value, parser_context)) {
+      return true;
+    }
   }
+  return false;
 }
-bool DOMGuard::isEqualInShadowTree(Element* shadow, Element* actual) {
-  if (shadow->tagName() != actual->tagName()) {
+
+bool DOMGuard::isEqualInShadowTree(DOMConstraintTree& tree, DOMConstraintTree::NodeId shadow, Element* actual) {
+  if (tree.Tag(shadow) != DOMConstraintTree::TagKey(actual)) {
     return false;
-  } else if (!attributeEquals(actual, "dtt-id", shadow->getAttribute("dtt-id"), actual->GetIdAttribute())) {
+  } else if (!attributeEquals(actual, "dtt-id", tree.Pattern(shadow, "dtt-id"), actual->GetIdAttribute())) {
     return false;
   }
   return true;
 }
 
-void DOMGuard::createShadowNode(Document* dom_constraint, Element* shadow_ptr, Node* node) {
+bool DOMGuard::hasIdPrefixInMode(Element* element, const AtomicString& id) {
+  if (id.IsNull()) {
+    return false;
+  }
+  return constraintConfig(element).HasIdPrefix(id);
+}
+
+DOMConstraintTree::NodeId DOMGuard::findShadowChild(DOMConstraintIndex* dom_constraint_index, DOMConstraintTree::NodeId shadow_parent, Element* element) {
+  DOMConstraintTree& tree = dom_constraint_index->Tree();
+  const AtomicString& id = element->GetIdAttribute();
+
+  if (hasIdPrefixInMode(element, id)) {
+    // A prefix from the constraint mode can pair ids that are not literally equal, so the hash cannot be used.
+    for (DOMConstraintTree::NodeId child = tree.FirstChild(shadow_parent); child != kNotFound; child = tree.NextSibling(child)) {
+      if (isEqualInShadowTree(tree, child, element)) {
+        return child;
+      }
+    }
+    return kNotFound;
+  }
+
+  // Siblings are numbered in tree order, so a wildcard child only wins over the literal hit if its id is lower.
+  DOMConstraintTree::NodeId literal_child = tree.FindLiteralChild(shadow_parent, DOMConstraintTree::TagKey(element), id);
+  for (DOMConstraintTree::NodeId child = tree.FirstWildcardChild(shadow_parent); child != kNotFound && child < literal_child; child = tree.NextWildcardSibling(child)) {
+    if (isEqualInShadowTree(tree, child, element)) {
+      return child;
+    }
+  }
+  return literal_child;
+}
+
+void DOMGuard::createShadowNode(DOMConstraintIndex* dom_constraint_index, DOMConstraintTree::NodeId shadow_ptr, Node* node) {
   auto *document_fragment = DynamicTo<DocumentFragment>(node);
   if (document_fragment) {
     for (auto *child = node->firstChild(); child; child = child->nextSibling()) {
-      createShadowNode(dom_constraint, shadow_ptr, child);
+      createShadowNode(dom_constraint_index, shadow_ptr, child);
     }
     return;
   }
@@ -369,20 +490,11 @@ void DOMGuard::createShadowNode(Document* dom_constraint, Element* shadow_ptr, N
     return;
   }
 
-  Element *shadow_element = nullptr;
-  for (auto *sibling = shadow_ptr->firstChild(); sibling; sibling = sibling->nextSibling()) {
-    Element *sibling_element = DynamicTo<Element>(sibling);
-    if (!sibling_element) {
-      continue;
-    }
-    if (isEqualInShadowTree(sibling_element, element)) {
-      shadow_element = sibling_element;
-      break;
-    }
-  }
+  DOMConstraintOverlay& overlay = dom_constraint_index->Overlay();
+  DOMConstraintTree::NodeId shadow_id = findShadowChild(dom_constraint_index, shadow_ptr, element);
 
-  if (!shadow_element) {
-    shadow_element = dom_constraint->CreateRawElement(QualifiedName(g_null_atom, AtomicString(element->tagName()), g_null_atom));
+  if (shadow_id == kNotFound) {
+    Element *shadow_element = overlay.CreateElement(AtomicString(element->tagName()));
     for (const Attribute& attribute : element->Attributes()) {
       if (attribute.GetName().LocalName() == "id") {
         shadow_element->setAttribute("dtt-id", attribute.Value());
@@ -392,26 +504,79 @@ void DOMGuard::createShadowNode(Document* dom_constraint, Element* shadow_ptr, N
       }
     }
 
-    if (shadow_ptr->tagName() == "HTML" && element->tagName() != "HEAD" && element->tagName() != "BODY") {
+    if (dom_constraint_index->Tree().Tag(shadow_ptr) == "HTML" && element->tagName() != "HEAD" && element->tagName() != "BODY") {
       shadow_element->setAttribute("dtt-dangling", "");
     }
     
-    shadow_ptr->appendChild(shadow_element);
+    shadow_id = dom_constraint_index->AppendShadowChild(shadow_ptr, shadow_element);
     // outputElementInsertion(shadow_ptr, shadow_element);
   } else {
+    // Only values that actually change are written, so that a shared constraint is not copied for nothing.
+    Element *shadow_element = dom_constraint_index->Tree().GetElement(shadow_id);
+    bool changed = false;
     for (const Attribute& attribute : element->Attributes()) {
       if (shouldMonitorAttribute(element, attribute.GetName())) {
-        shadow_element->setAttribute(attribute.GetName(), mergeShadowAttribute(element, attribute.GetName().LocalName(), shadow_element->getAttribute(attribute.GetName()), attribute.Value()));
+        AtomicString current_value = overlay.Current(shadow_element)->getAttribute(attribute.GetName());
+        AtomicString merged_value = mergeShadowAttribute(element, attribute.GetName().LocalName(), current_value, attribute.Value());
+        if (merged_value != current_value) {
+          overlay.EnsureWritable(shadow_element)->setAttribute(attribute.GetName(), merged_value);
+          changed = true;
+        }
       }
     }
+    if (changed) {
+      dom_constraint_index->DidChangeShadowAttributes(shadow_id);
+    }
   }
   
   for (auto *child = node->firstChild(); child; child = child->nextSibling()) {
-    createShadowNode(dom_constraint, shadow_element, child);
+    createShadowNode(dom_constraint_index, shadow_id, child);
   }
 }
 
-Node* DOMGuard::locateNodeInShadowTree(Node* node, ShadowTreeMatchResult& result) {
+DOMConstraintTree::NodeId DOMGuard::locateNodeInShadowTree(Node* node, ShadowTreeMatchResult& result) {
+  DOMConstraintIndex *dom_constraint_index = node->GetDocument().GetFrame()->GetDOMConstraintIndex();
+  DOMConstraintTree& tree = dom_constraint_index->Tree();
+
+  // 0. reuse the binding of `node`, or extend the binding of its parent by one level
+  Element *element = DynamicTo<Element>(node);
+  if (element && element->isConnected()) {
+    ShadowBinding *binding = dom_constraint_index->GetBinding(element, ShadowBindingKind::kEnforce);
+    if (binding) {
+      result = static_cast<ShadowTreeMatchResult>(binding->match_result);
+      return binding->shadow_node;
+    }
+
+    Node *parent = DOMConstraintIndex::BindingParent(element);
+    DOMConstraintTree::NodeId parent_shadow = kNotFound;
+    ShadowTreeMatchResult parent_result = ShadowTreeMatchResult::Found;
+    if (DynamicTo<Document>(parent)) {
+      parent_shadow = DOMConstraintTree::kDocumentId;
+    } else if (auto *parent_element = DynamicTo<Element>(parent)) {
+      ShadowBinding *parent_binding = dom_constraint_index->GetBinding(parent_element, ShadowBindingKind::kEnforce);
+      if (parent_binding) {
+        parent_shadow = parent_binding->shadow_node;
+        parent_result = static_cast<ShadowTreeMatchResult>(parent_binding->match_result);
+      }
+    }
+
+    if (parent_shadow != kNotFound) {
+      if (parent_result == ShadowTreeMatchResult::WhitelistMatch || tree.IsWhitelisted(parent_shadow)) {
+        result = ShadowTreeMatchResult::WhitelistMatch;
+        dom_constraint_index->SetBinding(element, ShadowBindingKind::kEnforce, parent_shadow, result);
+        return parent_shadow;
+      }
+      DOMConstraintTree::NodeId found_child = findShadowChild(dom_constraint_index, parent_shadow, element);
+      if (found_child == kNotFound) {
+        result = ShadowTreeMatchResult::NotFound;
+        return kNotFound;
+      }
+      result = ShadowTreeMatchResult::Found;
+      dom_constraint_index->SetBinding(element, ShadowBindingKind::kEnforce, found_child, result);
+      return found_child;
+    }
+  }
+
   Node *ptr = node;
   NodeVector ancestors;
   do {
@@ -421,11 +586,12 @@ Node* DOMGuard::locateNodeInShadowTree(Node* node, ShadowTreeMatchResult& result
   auto *root = DynamicTo<Document>(ancestors.back().Get());
   if (!root) {
     result = ShadowTreeMatchResult::RootIsNotDocument;
-    return nullptr;
+    return kNotFound;
   }
   ancestors.pop_back();
 
-  Node *shadow_ptr = node->GetDocument().GetFrame()->DOMConstraint();
+  DOMConstraintTree::NodeId shadow_ptr = DOMConstraintTree::kDocumentId;
+  bool can_bind = node->isConnected();
     
   // 1. go through shadow ancestors of `node` in `dom_constraint` until we can no longer find a matching shadow element 
   auto ancestor = ancestors.rbegin();
@@ -436,24 +602,25 @@ Node* DOMGuard::locateNodeInShadowTree(Node* node, ShadowTreeMatchResult& result
     }
     auto *ancestor_element = DynamicTo<Element>((*ancestor).Get());
     DCHECK(ancestor_element); // A non-Element and non-DocumentFragment ancestor would trigger this DCHECK
-    Element *found_child = nullptr;
-    for (auto *child = shadow_ptr->firstChild(); child; child = child->nextSibling()) {
-      auto *child_element = DynamicTo<Element>(child);
-      if (!child_element) {
-        continue;
-      }
-      if (!isEqualInShadowTree(child_element, ancestor_element)) {
-        continue;
-      }
-      found_child = child_element;
-      break;
-    }
+    DOMConstraintTree::NodeId found_child = findShadowChild(dom_constraint_index, shadow_ptr, ancestor_element);
 
-    if (found_child) {
+    if (found_child != kNotFound) {
       shadow_ptr = found_child;
-      if (found_child->getAttribute("dtt-whitelist") != g_null_atom) {
+      if (can_bind) {
+        dom_constraint_index->SetBinding(ancestor_element, ShadowBindingKind::kEnforce, shadow_ptr, ShadowTreeMatchResult::Found);
+      }
+      if (tree.IsWhitelisted(found_child)) {
         if (ancestor + 1 != ancestors.rend()) {
           result = ShadowTreeMatchResult::WhitelistMatch;
+          if (can_bind) {
+            // Everything below binds to the whitelisted node; binding the elements in between keeps each binding's parent bound.
+            for (auto below = ancestor + 1; below != ancestors.rend(); ++below) {
+              auto *below_element = DynamicTo<Element>((*below).Get());
+              if (below_element) {
+                dom_constraint_index->SetBinding(below_element, ShadowBindingKind::kEnforce, shadow_ptr, result);
+              }
+            }
+          }
         } else {
           result = ShadowTreeMatchResult::Found;
         }
@@ -466,14 +633,53 @@ Node* DOMGuard::locateNodeInShadowTree(Node* node, ShadowTreeMatchResult& result
 
   if (ancestor != ancestors.rend()) {
     result = ShadowTreeMatchResult::NotFound;
-    return nullptr;
+    return kNotFound;
   } else {
     result = ShadowTreeMatchResult::Found;
     return shadow_ptr;
   }
 }
 
-Node* DOMGuard::locateNodeAndCreateAncestorsInShadowTree(Node* node, ShadowTreeMatchResult& result) {
+DOMConstraintTree::NodeId DOMGuard::locateNodeAndCreateAncestorsInShadowTree(Node* node, ShadowTreeMatchResult& result) {
+  DOMConstraintIndex *dom_constraint_index = node->GetDocument().GetFrame()->GetDOMConstraintIndex();
+  DOMConstraintTree& tree = dom_constraint_index->Tree();
+
+  // 0. reuse the binding of `node`, or extend the binding of its parent by one level
+  Element *element = DynamicTo<Element>(node);
+  if (element && element->isConnected()) {
+    ShadowBinding *binding = dom_constraint_index->GetBinding(element, ShadowBindingKind::kRecord);
+    if (binding) {
+      result = ShadowTreeMatchResult::Found;
+      return binding->shadow_node;
+    }
+
+    Node *parent = DOMConstraintIndex::BindingParent(element);
+    DOMConstraintTree::NodeId parent_shadow = kNotFound;
+    if (DynamicTo<Document>(parent)) {
+      parent_shadow = DOMConstraintTree::kDocumentId;
+    } else if (auto *parent_element = DynamicTo<Element>(parent)) {
+      ShadowBinding *parent_binding = dom_constraint_index->GetBinding(parent_element, ShadowBindingKind::kRecord);
+      if (parent_binding) {
+        parent_shadow = parent_binding->shadow_node;
+      }
+    }
+
+    if (parent_shadow != kNotFound) {
+      DOMConstraintTree::NodeId shadow_id = findShadowChild(dom_constraint_index, parent_shadow, element);
+      if (shadow_id == kNotFound) {
+        Element *shadow_element = dom_constraint_index->Overlay().CreateElement(AtomicString(element->tagName()));
+        shadow_element->setAttribute("dtt-id", element->GetIdAttribute());
+        if (tree.Tag(parent_shadow) == "HTML" && shadow_element->tagName() != "HEAD" && shadow_element->tagName() != "BODY") {
+          shadow_element->setAttribute("dtt-dangling", "");
+        }
+        shadow_id = dom_constraint_index->AppendShadowChild(parent_shadow, shadow_element);
+      }
+      result = ShadowTreeMatchResult::Found;
+      dom_constraint_index->SetBinding(element, ShadowBindingKind::kRecord, shadow_id, result);
+      return shadow_id;
+    }
+  }
+
   Node *ptr = node;
   NodeVector ancestors;
   do {
@@ -483,14 +689,14 @@ Node* DOMGuard::locateNodeAndCreateAncestorsInShadowTree(Node* node, ShadowTreeM
   auto *root = DynamicTo<Document>(ancestors.back().Get());
   if (!root || root != node->GetDocument()) {
     result = ShadowTreeMatchResult::RootIsNotDocument;
-    return nullptr;
+    return kNotFound;
   }
   ancestors.pop_back();
 
-  Document *dom_constraint = node->GetDocument().GetFrame()->DOMConstraint();
-  Node *shadow_ptr = node->GetDocument().GetFrame()->DOMConstraint();
+  DOMConstraintTree::NodeId shadow_ptr = DOMConstraintTree::kDocumentId;
   bool shadow_ptr_is_root = true;
   bool shadow_ptr_is_html = true;
+  bool can_bind = node->isConnected();
     
   // 1. go through shadow ancestors of `node` in `dom_constraint` until we can no longer find a matching shadow element 
   auto ancestor = ancestors.rbegin();
@@ -501,21 +707,13 @@ Node* DOMGuard::locateNodeAndCreateAncestorsInShadowTree(Node* node, ShadowTreeM
     }
     auto *ancestor_element = DynamicTo<Element>((*ancestor).Get());
     DCHECK(ancestor_element); // A non-Element and non-DocumentFragment ancestor would trigger this DCHECK
-    Element *found_child = nullptr;
-    for (auto *child = shadow_ptr->firstChild(); child; child = child->nextSibling()) {
-      auto *child_element = DynamicTo<Element>(child);
-      if (!child_element) {
-        continue;
-      }
-      if (!isEqualInShadowTree(child_element, ancestor_element)) {
-        continue;
-      }
-      found_child = child_element;
-      break;
-    }
+    DOMConstraintTree::NodeId found_child = findShadowChild(dom_constraint_index, shadow_ptr, ancestor_element);
 
-    if (found_child) {
+    if (found_child != kNotFound) {
       shadow_ptr = found_child;
+      if (can_bind) {
+        dom_constraint_index->SetBinding(ancestor_element, ShadowBindingKind::kRecord, shadow_ptr, ShadowTreeMatchResult::Found);
+      }
       if (shadow_ptr_is_root) {
         shadow_ptr_is_root = false;
       } else if (shadow_ptr_is_html) {
@@ -534,7 +732,7 @@ Node* DOMGuard::locateNodeAndCreateAncestorsInShadowTree(Node* node, ShadowTreeM
     }
     auto *ancestor_element = DynamicTo<Element>((*ancestor).Get());
     DCHECK(ancestor_element); // A non-Element and non-DocumentFragment ancestor would trigger this DCHECK
-    Element *shadow_element = dom_constraint->CreateRawElement(QualifiedName(g_null_atom, AtomicString(ancestor_element->tagName()), g_null_atom));
+    Element *shadow_element = dom_constraint_index->Overlay().CreateElement(AtomicString(ancestor_element->tagName()));
     shadow_element->setAttribute("dtt-id", ancestor_element->GetIdAttribute());
     // Should we also clone other attributes here, similar to createShadowNode?
     // The shadow_element created here is not a shadow of any node being inserted, 
@@ -544,7 +742,10 @@ Node* DOMGuard::locateNodeAndCreateAncestorsInShadowTree(Node* node, ShadowTreeM
     if (shadow_ptr_is_html && shadow_element->tagName() != "HEAD" && shadow_element->tagName() != "BODY") {
       shadow_element->setAttribute("dtt-dangling", "");
     }
-    shadow_ptr = shadow_ptr->appendChild(shadow_element);
+    shadow_ptr = dom_constraint_index->AppendShadowChild(shadow_ptr, shadow_element);
+    if (can_bind) {
+      dom_constraint_index->SetBinding(ancestor_element, ShadowBindingKind::kRecord, shadow_ptr, ShadowTreeMatchResult::Found);
+    }
   }
   result = ShadowTreeMatchResult::Found;
   return shadow_ptr;
@@ -602,10 +803,18 @@ AtomicString DOMGuard::mergeShadowAttribute(Element *element, const AtomicString
 
   // outputAttributeModification(element, attribute_name, new_value);
 
-  return escapeAndAddToAttributeValue(current_value, new_value);
+  AtomicString merged_value = escapeAndAddToAttributeValue(current_value, new_value);
+  // Script attributes are compared token by token and URL attributes by origin, so a glob means nothing to them.
+  if (isScriptAttribute(element, attribute_name) || isURLAttribute(element, attribute_name)) {
+    return merged_value;
+  }
+  return generalizeShadowValue(merged_value);
 }
 
-AtomicString DOMGuard::mergeShadowProperty(Element *element, const CSSProperty& property, const AtomicString& current_value, const CSSValue* new_value, const CSSParserContext* parser_context) {
+// |current_pattern| is the cached pattern of the shadow property, so the numeric ranges a merge is checked against
+// are widened as alternatives are appended rather than rebuilt from every alternative.
+AtomicString DOMGuard::mergeShadowProperty(Element *element, const CSSProperty& property, DOMConstraintPattern& current_pattern, const CSSValue* new_value, const CSSParserContext* parser_context) {
+  const AtomicString& current_value = current_pattern.Source();
   if (current_value.length() == 0) {
     // if (new_value) {
     //   outputPropertyModification(element, property.GetPropertyNameString(), new_value);
@@ -613,20 +822,70 @@ AtomicString DOMGuard::mergeShadowProperty(Element *element, const CSSProperty&
     return new_value ? AtomicString(new_value->CssText()) : g_null_atom;
   }
 
-  if (propertyEquals(element, property, current_value, new_value, parser_context)) {
+  if (propertyEquals(element, property, current_pattern, new_value, parser_context)) {
     return current_value;
   }
 
   // outputPropertyModification(element, property.GetPropertyNameString(), new_value);
   
-  return escapeAndAddToAttributeValue(current_value, new_value ? AtomicString(new_value->CssText()) : g_null_atom);
+  // The CSS text of every alternative is matched as a glob before it is compared as a value.
+  return generalizeShadowValue(escapeAndAddToAttributeValue(current_value, new_value ? AtomicString(new_value->CssText()) : g_null_atom));
+}
+
+AtomicString DOMGuard::generalizeShadowValue(const AtomicString& value) {
+  DOMConstraintPattern *pattern = MakeGarbageCollected<DOMConstraintPattern>(value);
+  if (pattern->Alternatives().size() <= kMaxRecordedAlternatives) {
+    return value;
+  }
+  return GeneralizeAlternatives(*pattern, kMaxRecordedAlternatives);
+}
+
+DOMConstraintTree::NodeId DOMGuard::matchingChildInShadowTree(DOMConstraintIndex *dom_constraint_index, Element *element, DOMConstraintTree::NodeId shadow_parent) {
+  DOMConstraintTree& tree = dom_constraint_index->Tree();
+  DCHECK_NE(shadow_parent, kNotFound);
+  ShadowSubtreeSummary::ElementKeys keys = ShadowSubtreeSummary::KeysFor(element, hasIdPrefixInMode(element, element->GetIdAttribute()));
+  if (!tree.Summary(shadow_parent).MayContain(keys)) {
+    return kNotFound;
+  }
+  for (DOMConstraintTree::NodeId child = tree.FirstChild(shadow_parent); child != kNotFound; child = tree.NextSibling(child)) {
+    if (tree.MayMatch(child, keys) && matchingNode(tree, element, child)) {
+      return child;
+    }
+  }
+  return kNotFound;
+}
+
+bool DOMGuard::hasMatchingNodeInShadowTree(Node *node, DOMConstraintTree::NodeId shadow_parent) {
+  Element *element = DynamicTo<Element>(node);
+  DOMConstraintTree& tree = element->GetDocument().GetFrame()->GetDOMConstraintIndex()->Tree();
+  DCHECK_NE(shadow_parent, kNotFound);
+  ShadowSubtreeSummary::ElementKeys keys = ShadowSubtreeSummary::KeysFor(element, hasIdPrefixInMode(element, element->GetIdAttribute()));
+  return hasMatchingNodeInShadowTree(tree, keys, element, shadow_parent);
+}
+
+bool DOMGuard::hasMatchingNodeInShadowTree(DOMConstraintTree& tree, const ShadowSubtreeSummary::ElementKeys& keys, Element *element, DOMConstraintTree::NodeId shadow_parent) {
+  // Subtrees whose summary rules the element out are skipped without being walked.
+  if (!tree.Summary(shadow_parent).MayContain(keys)) {
+    return false;
+  }
+  for (DOMConstraintTree::NodeId child = tree.FirstChild(shadow_parent); child != kNotFound; child = tree.NextSibling(child)) {
+    if ((tree.MayMatch(child, keys) && matchingNode(tree, element, child)) || hasMatchingNodeInShadowTree(tree, keys, element, child)) {
+      return true;
+    }
+  }
+  return false;
 }
 
-bool DOMGuard::hasMatchingSubtreeInShadowTree(Node *node, Node *shadow_parent) {
+// Checks `node`, which is about to be inserted, against the shadow tree in a single pass. `shadow_parent` and `match_result` are what
+// the node's parent resolved to: below a Found parent every element needs a matching shadow child, below a WhitelistMatch it needs
+// a matching shadow node anywhere under the whitelisted one. `binding_parent` and `binding_result` follow what
+// locateNodeInShadowTree would bind the inserted elements to (kNotFound if they cannot be bound), so that later probes on them need
+// no ancestor walk. Every element that would get its pending attribute changes executed is appended to `inserted_elements`.
+bool DOMGuard::validateInsertedSubtree(DOMConstraintIndex *dom_constraint_index, Node *node, DOMConstraintTree::NodeId shadow_parent, ShadowTreeMatchResult match_result, DOMConstraintTree::NodeId binding_parent, ShadowTreeMatchResult binding_result, HeapVector<InsertedElement>& inserted_elements) {
   auto *document_fragment = DynamicTo<DocumentFragment>(node);
   if (document_fragment) {
     for (auto *child = node->firstChild(); child; child = child->nextSibling()) {
-      if (!hasMatchingSubtreeInShadowTree(child, shadow_parent)) {
+      if (!validateInsertedSubtree(dom_constraint_index, child, shadow_parent, match_result, binding_parent, binding_result, inserted_elements)) {
         return false;
       }
     }
@@ -638,96 +897,125 @@ bool DOMGuard::hasMatchingSubtreeInShadowTree(Node *node, Node *shadow_parent) {
     return true;
   }
 
-  Node *shadow_node = nullptr;
-  for (Node* child = shadow_parent->firstChild(); child; child = child->nextSibling()) {
-    if ((shadow_node = matchingNode(node, child))) {
-      break;
+  DOMConstraintTree::NodeId child_shadow_parent = shadow_parent;
+  if (match_result == ShadowTreeMatchResult::WhitelistMatch) {
+    if (!hasMatchingNodeInShadowTree(node, shadow_parent)) {
+      LOG(INFO) << "hasMatchingNodeInShadowTree failed";
+      LOG(INFO) << CreateMarkup(node).Utf8();
+      node->PrintNodePathTo(LOG_STREAM(INFO));
+      return false;
+    }
+  } else {
+    child_shadow_parent = matchingChildInShadowTree(dom_constraint_index, element, shadow_parent);
+    if (child_shadow_parent == kNotFound) {
+      LOG(INFO) << "Matching shadow node not found for " << CreateMarkup(node).Utf8();
+      dom_constraint_index->Tree().GetNode(shadow_parent)->PrintNodePathTo(LOG_STREAM(INFO));
+      return false;
     }
   }
-  if (!shadow_node) {
-    LOG(INFO) << "Matching shadow node not found for " << CreateMarkup(node).Utf8();
-    shadow_parent->PrintNodePathTo(LOG_STREAM(INFO));
-    return false;
+
+  DOMConstraintTree::NodeId shadow_node = kNotFound;
+  ShadowTreeMatchResult shadow_node_result = ShadowTreeMatchResult::Found;
+  if (binding_parent != kNotFound) {
+    if (binding_result == ShadowTreeMatchResult::WhitelistMatch || dom_constraint_index->Tree().IsWhitelisted(binding_parent)) {
+      shadow_node = binding_parent;
+      shadow_node_result = ShadowTreeMatchResult::WhitelistMatch;
+    } else {
+      shadow_node = findShadowChild(dom_constraint_index, binding_parent, element);
+    }
   }
+  inserted_elements.push_back(InsertedElement{element, shadow_node, shadow_node_result});
 
   for (Node* child = node->firstChild(); child; child = child->nextSibling()) {
-    if (!hasMatchingSubtreeInShadowTree(child, shadow_node)) {
+    if (!validateInsertedSubtree(dom_constraint_index, child, child_shadow_parent, match_result, shadow_node, shadow_node_result, inserted_elements)) {
       return false;
     }
   }
-  return true;
-}
 
-bool DOMGuard::hasMatchingNodeInShadowTree(Node *node, Node *shadow_parent) {
-  for (Node* child = shadow_parent->firstChild(); child; child = child->nextSibling()) {
-    if (matchingNode(node, child) || hasMatchingNodeInShadowTree(node, child)) {
-      return true;
-    }
+  // Author shadow trees are not checked, but their pending attribute changes are executed along with the rest.
+  ShadowRoot *shadow_root = element->AuthorShadowRoot();
+  if (shadow_root) {
+    collectInsertedElements(shadow_root, inserted_elements);
   }
-  return false;
+  return true;
 }
 
-bool DOMGuard::matchesNodeWhitelistInShadowTree(Node *node, Node *shadow_parent) {
-  auto *document_fragment = DynamicTo<DocumentFragment>(node);
-  if (document_fragment) {
-    for (auto *child = node->firstChild(); child; child = child->nextSibling()) {
-      if (!matchesNodeWhitelistInShadowTree(child, shadow_parent)) {
-        return false;
-      }
-    }
-    return true;
+// Appends the elements of `node` in the order executePendingAttributeChanges visits them, without bindings.
+void DOMGuard::collectInsertedElements(Node *node, HeapVector<InsertedElement>& inserted_elements) {
+  Element *element = DynamicTo<Element>(node);
+  if (element) {
+    inserted_elements.push_back(InsertedElement{element, kNotFound, ShadowTreeMatchResult::NotFound});
+  } else if (!DynamicTo<DocumentFragment>(node)) {
+    return;
   }
 
-  if (!DynamicTo<Element>(node)) {
-    return true;
+  for (auto *child = node->firstChild(); child; child = child->nextSibling()) {
+    collectInsertedElements(child, inserted_elements);
   }
 
-  if (!hasMatchingNodeInShadowTree(node, shadow_parent)) {
-    LOG(INFO) << "hasMatchingNodeInShadowTree failed";
-    LOG(INFO) << CreateMarkup(node).Utf8();
-    node->PrintNodePathTo(LOG_STREAM(INFO));
-    return false;
+  ShadowRoot *shadow_root = element ? element->AuthorShadowRoot() : nullptr;
+  if (shadow_root) {
+    collectInsertedElements(shadow_root, inserted_elements);
   }
+}
 
-  for (Node* child = node->firstChild(); child; child = child->nextSibling()) {
-    if (!matchesNodeWhitelistInShadowTree(child, shadow_parent)) {
-      return false;
+// Binds the elements of an allowed insertion, then executes their pending attribute changes in executePendingAttributeChanges order.
+void DOMGuard::commitInsertedElements(DOMConstraintIndex *dom_constraint_index, const HeapVector<InsertedElement>& inserted_elements) {
+  for (const InsertedElement& inserted_element : inserted_elements) {
+    // Every element gets visited below, so the flags that lead a flush to them can go.
+    inserted_element.element->ClearChildHasPendingAttributeChanges();
+    if (inserted_element.shadow_node != kNotFound) {
+      dom_constraint_index->SetBinding(inserted_element.element, ShadowBindingKind::kEnforce, inserted_element.shadow_node, inserted_element.match_result);
     }
   }
-  return true;
+  // Bindings go first: an id set by a pending change invalidates the binding made from the old id.
+  for (const InsertedElement& inserted_element : inserted_elements) {
+    inserted_element.element->ExecutePendingAttributeChanges();
+  }
 }
 
-bool DOMGuard::matchesAttributeWhitelistInShadowTree(Element *element, const AtomicString& attribute_name, const AtomicString& attribute_value, Node *shadow_parent) {
-  for (Node* child = shadow_parent->firstChild(); child; child = child->nextSibling()) {
-    Element *child_element = DynamicTo<Element>(child);
-    if (!child_element) {
-      continue;
-    } 
-    if (attributeEquals(element, attribute_name, child_element->getAttribute(attribute_name), attribute_value) || matchesAttributeWhitelistInShadowTree(element, attribute_name, attribute_value, child)) {
+bool DOMGuard::matchesAttributeWhitelistInShadowTree(Element *element, const AtomicString& attribute_name, const AtomicString& attribute_value, DOMConstraintTree::NodeId shadow_parent) {
+  DOMConstraintTree& tree = element->GetDocument().GetFrame()->GetDOMConstraintIndex()->Tree();
+  DCHECK_NE(shadow_parent, kNotFound);
+  unsigned attribute_key = attribute_value != g_null_atom ? ShadowSubtreeSummary::AttributeKey(attribute_name) : 0;
+  return matchesAttributeWhitelistInShadowTree(tree, element, attribute_name, attribute_value, attribute_key, shadow_parent);
+}
+
+bool DOMGuard::matchesAttributeWhitelistInShadowTree(DOMConstraintTree& tree, Element *element, const AtomicString& attribute_name, const AtomicString& attribute_value, unsigned attribute_key, DOMConstraintTree::NodeId shadow_parent) {
+  // A shadow element without the attribute only matches a removal, so a new value needs the name somewhere below.
+  if (attribute_value != g_null_atom && !tree.Summary(shadow_parent).MayContainAttribute(attribute_key)) {
+    return false;
+  }
+  for (DOMConstraintTree::NodeId child = tree.FirstChild(shadow_parent); child != kNotFound; child = tree.NextSibling(child)) {
+    if (attributeEquals(element, attribute_name, tree.Pattern(child, attribute_name), attribute_value) || matchesAttributeWhitelistInShadowTree(tree, element, attribute_name, attribute_value, attribute_key, child)) {
       return true;
     }
   }
   return false;
 }
 
-bool DOMGuard::matchesPropertyWhitelistInShadowTree(Element *element, Element *shadow_parent, const ComputedStyle *style, bool slow_path = false) {
-  for (Node* child = shadow_parent->firstChild(); child; child = child->nextSibling()) {
-    Element *child_element = DynamicTo<Element>(child);
-    if (!child_element) {
-      continue;
-    }
-    int count = 0;
-    for (CSSPropertyID property_id : css_property_ids_) {
+bool DOMGuard::matchesPropertyWhitelistInShadowTree(Element *element, DOMConstraintTree::NodeId shadow_parent, const ComputedStyle *style, bool slow_path) {
+  DOMConstraintIndex *dom_constraint_index = element->GetDocument().GetFrame()->GetDOMConstraintIndex();
+  DCHECK_NE(shadow_parent, kNotFound);
+  return matchesPropertyWhitelistInShadowTree(dom_constraint_index, element, shadow_parent, style, slow_path);
+}
+
+// Walks the tree rather than the DOM children of the shadow element, so children appended through the overlay count
+// too. Only the ComputedStyle of a shadow child comes from its Element.
+bool DOMGuard::matchesPropertyWhitelistInShadowTree(DOMConstraintIndex *dom_constraint_index, Element *element, DOMConstraintTree::NodeId shadow_parent, const ComputedStyle *style, bool slow_path) {
+  DOMConstraintTree& tree = dom_constraint_index->Tree();
+  for (DOMConstraintTree::NodeId child = tree.FirstChild(shadow_parent); child != kNotFound; child = tree.NextSibling(child)) {
+    Element *child_element = To<Element>(tree.GetNode(child));
+    for (wtf_size_t count : modified_property_indices_) {
       if (!is_css_property_modified_[count]) {
-        count += 1;
         continue;
       }
-      const CSSProperty& property_class = CSSProperty::Get(ResolveCSSPropertyID(property_id));
+      const CSSProperty& property_class = CSSProperty::Get(ResolveCSSPropertyID(css_property_ids_[count]));
       const CSSValue* new_value = css_property_values_[count];
 
       if (slow_path) {
         AtomicString shadow_attribute_name = "dtt-s-" + property_class.GetPropertyNameString();
-        if (propertyEquals(element, property_class, child_element->getAttribute(shadow_attribute_name), new_value, element->GetDocument().ElementSheet().Contents()->ParserContext())) {
+        if (propertyEquals(element, property_class, tree.Pattern(child, shadow_attribute_name), new_value, element->GetDocument().ElementSheet().Contents()->ParserContext())) {
           is_css_property_modified_[count] = false;
           modified_property_count_ -= 1;
         }
@@ -738,40 +1026,23 @@ bool DOMGuard::matchesPropertyWhitelistInShadowTree(Element *element, Element *s
           if (fast_match_result == 1) {
             is_css_property_modified_[count] = false;
             modified_property_count_ -= 1;
-          } else {
-            const CSSValue* shadow_css_value = ComputedStyleUtils::ComputedPropertyValue(property_class, *shadow_computed_style);
-            String shadow_css_text = shadow_css_value ? shadow_css_value->CssText() : "";
-            String new_css_text = new_value ? new_value->CssText() : "";
-            if (shadow_css_text == new_css_text) {
-              is_css_property_modified_[count] = false;
-              modified_property_count_ -= 1;
-            }
+          } else if (dom_constraint_index->ShadowStyleText(child_element, property_class) == newCssText(count)) {
+            is_css_property_modified_[count] = false;
+            modified_property_count_ -= 1;
           }
         }
       }
-      count += 1;
     }
-    if (modified_property_count_ == 0 || matchesPropertyWhitelistInShadowTree(element, child_element, style, slow_path)) {
+    if (modified_property_count_ == 0 || matchesPropertyWhitelistInShadowTree(dom_constraint_index, element, child, style, slow_path)) {
       return true;
     }
   }
   return false;
 }
 
-Node* DOMGuard::matchingNode(Node *node, Node *shadow_node) {
-  Element *element = DynamicTo<Element>(node);
-  Element *shadow_element = DynamicTo<Element>(shadow_node);
-
-  if (!shadow_element) { // shadow_node can be a text node
-    return nullptr;
-  }
-
-  if (element->tagName() != shadow_element->tagName()) {
-    return nullptr;
-  }
-
-  if (!attributeEquals(element, "dtt-id", shadow_element->getAttribute("dtt-id"), element->GetIdAttribute())) {
-    return nullptr;
+bool DOMGuard::matchingNode(DOMConstraintTree& tree, Element *element, DOMConstraintTree::NodeId shadow_node) {
+  if (!isEqualInShadowTree(tree, shadow_node, element)) {
+    return false;
   }
 
   for (const Attribute& attribute : element->Attributes()) {
@@ -779,26 +1050,15 @@ Node* DOMGuard::matchingNode(Node *node, Node *shadow_node) {
       continue;
     }
 
-    if (!attributeEquals(element, attribute.GetName().LocalName(), shadow_element->getAttribute(attribute.GetName()), attribute.Value())) {
-      return nullptr;
+    if (!attributeEquals(element, attribute.GetName().LocalName(), tree.Pattern(shadow_node, attribute.GetName().LocalName()), attribute.Value())) {
+      return false;
     }
   }
 
   // TODO: Sometimes `element` should be required to have a certain attribute with a certain value (e.g. `<a target="some_window"`).
   // We should maintain a list of such attributes, and iterate through them here.
 
-  return shadow_node;
-}
-
-bool DOMGuard::isDescendantOfUserAgentShadowRoot(Node* node) {
-  do {
-    ShadowRoot *shadow_root = DynamicTo<ShadowRoot>(node);
-    if (shadow_root && shadow_root->IsUserAgent()) {
-      return true;
-    }
-  } while ((node = node->ParentOrShadowHostNode()));
-
-  return false;
+  return true;
 }
 
 void DOMGuard::WillInsertDOMNodeExtended(Node* parent, Node *node, Node *next, bool &allowed) {
@@ -806,13 +1066,27 @@ void DOMGuard::WillInsertDOMNodeExtended(Node* parent, Node *node, Node *next, b
 
   // parent->PrintNodePathTo(LOG_STREAM(INFO));
 
-  if (!parent->GetDocument().domWindow()) {
+  LocalFrame *frame = parent->GetDocument().GetFrame();
+  if (!frame) {
     return;
   }
+  (this->*frame->GetDOMGuardProbes().will_insert_dom_node)(parent, node, next, allowed);
+}
+
+template <>
+void DOMGuard::willInsertDOMNode<DOMConstraintConfig::Mode::kIdle>(Node* parent, Node *node, Node *next, bool &allowed) {
+  // Attribute changes held back until insertion still have to be applied.
+  executePendingAttributeChanges(node);
+}
+
+template <DOMConstraintConfig::Mode mode>
+void DOMGuard::willInsertDOMNode(Node* parent, Node *node, Node *next, bool &allowed) {
+  // `node` may be moving, so bindings below it have to be checked against their parents again before use.
+  parent->GetDocument().GetFrame()->GetDOMConstraintIndex()->MarkBindingsUnverified();
 
   // LOG(INFO) << "1";
   
-  if (isDescendantOfUserAgentShadowRoot(parent)) {
+  if (parent->IsInUserAgentShadowTree()) {
     executePendingAttributeChanges(node);
     return;
   }
@@ -827,31 +1101,31 @@ void DOMGuard::WillInsertDOMNodeExtended(Node* parent, Node *node, Node *next, b
 
   // LOG(INFO) << "3";
 
-  String dom_constraint_mode = parent->GetDocument().GetFrame()->DOMConstraintMode();
-  if (dom_constraint_mode.length() && dom_constraint_mode[0] == 'r') {
-  // if (dom_constraint_mode == "record") {
+  if (mode == DOMConstraintConfig::Mode::kRecord) {
     ShadowTreeMatchResult match_result = ShadowTreeMatchResult::NotFound;
-    Element *shadow_ptr = DynamicTo<Element>(locateNodeAndCreateAncestorsInShadowTree(parent, match_result));
+    DOMConstraintTree::NodeId shadow_ptr = locateNodeAndCreateAncestorsInShadowTree(parent, match_result);
     // LOG(INFO) << "match_result = " << match_result;
     if (match_result != ShadowTreeMatchResult::Found) {
       return;
     }
 
     // 3. create a shadow of `node` under `shadow_ptr`
-    Document *dom_constraint = parent->GetDocument().GetFrame()->DOMConstraint();
-    createShadowNode(dom_constraint, shadow_ptr, node);
+    createShadowNode(parent->GetDocument().GetFrame()->GetDOMConstraintIndex(), shadow_ptr, node);
     executePendingAttributeChanges(node);
-  } else if (dom_constraint_mode.length() && dom_constraint_mode[0] == 'e') {
-  // } else if (dom_constraint_mode == "enforce") {
+  } else {
     ShadowTreeMatchResult match_result = ShadowTreeMatchResult::NotFound;
-    Node *shadow_parent = locateNodeInShadowTree(parent, match_result);
+    DOMConstraintTree::NodeId shadow_parent = locateNodeInShadowTree(parent, match_result);
 
     if (match_result == ShadowTreeMatchResult::RootIsNotDocument) {
       allowed = true;
-    } else if (match_result == ShadowTreeMatchResult::Found) {
-      allowed = hasMatchingSubtreeInShadowTree(node, shadow_parent);
-    } else if (match_result == ShadowTreeMatchResult::WhitelistMatch) {
-      allowed = matchesNodeWhitelistInShadowTree(node, shadow_parent);
+    } else if (match_result == ShadowTreeMatchResult::Found || match_result == ShadowTreeMatchResult::WhitelistMatch) {
+      // The subtree is checked, bound and collected in one walk; nothing is applied unless all of it is allowed.
+      DOMConstraintIndex *dom_constraint_index = parent->GetDocument().GetFrame()->GetDOMConstraintIndex();
+      HeapVector<InsertedElement> inserted_elements;
+      allowed = validateInsertedSubtree(dom_constraint_index, node, shadow_parent, match_result, parent->isConnected() ? shadow_parent : kNotFound, match_result, inserted_elements);
+      if (allowed) {
+        commitInsertedElements(dom_constraint_index, inserted_elements);
+      }
     } else {
       allowed = false;
     }
@@ -861,8 +1135,6 @@ void DOMGuard::WillInsertDOMNodeExtended(Node* parent, Node *node, Node *next, b
       // Element *parent_element = DynamicTo<Element>(parent);
       // LOG(INFO) << CreateMarkup(parent).Utf8();
       // LOG(INFO) << parent_element->tagName() << " "  << parent_element->getAttribute("id");
-    } else if (match_result != ShadowTreeMatchResult::RootIsNotDocument) {
-      executePendingAttributeChanges(node);
     }
   }
 }
@@ -874,43 +1146,61 @@ void DOMGuard::WillModifyDOMAttrExtended(Element* element,
                                 bool &allowed) {
   allowed = true;
 
-  if (!element->GetDocument().domWindow()) {
+  LocalFrame *frame = element->GetDocument().GetFrame();
+  if (!frame) {
     return;
   }
+  (this->*frame->GetDOMGuardProbes().will_modify_dom_attr)(element, name, old_value, new_value, allowed);
+}
 
-  if (isDescendantOfUserAgentShadowRoot(element)) {
+template <>
+void DOMGuard::willModifyDOMAttr<DOMConstraintConfig::Mode::kIdle>(Element* element, const QualifiedName& name, const AtomicString& old_value, const AtomicString& new_value, bool &allowed) {}
+
+template <DOMConstraintConfig::Mode mode>
+void DOMGuard::willModifyDOMAttr(Element* element, const QualifiedName& name, const AtomicString& old_value, const AtomicString& new_value, bool &allowed) {
+  if (element->IsInUserAgentShadowTree()) {
     return;
   }
 
+  if (name.LocalName() == "id" && old_value != new_value) {
+    // Descendants were resolved through this id; they find out when the element is bound again.
+    element->GetDocument().GetFrame()->GetDOMConstraintIndex()->MarkBindingsUnverified();
+  }
+
   if (!shouldMonitorAttribute(element, name)) {
     return;
   }
 
-  String dom_constraint_mode = element->GetDocument().GetFrame()->DOMConstraintMode();
-  if (dom_constraint_mode.length() && dom_constraint_mode[0] == 'r') {
-  // if (dom_constraint_mode == "record") {
+  if (mode == DOMConstraintConfig::Mode::kRecord) {
     ShadowTreeMatchResult match_result = ShadowTreeMatchResult::NotFound;
-    Element *shadow_ptr = DynamicTo<Element>(locateNodeAndCreateAncestorsInShadowTree(element, match_result));
+    DOMConstraintTree::NodeId shadow_id = locateNodeAndCreateAncestorsInShadowTree(element, match_result);
     if (match_result != ShadowTreeMatchResult::Found) {
       return;
     }
-    shadow_ptr->setAttribute(name, mergeShadowAttribute(shadow_ptr, name.LocalName(), shadow_ptr->getAttribute(name), new_value));
-  } else if (dom_constraint_mode.length() && dom_constraint_mode[0] == 'e') {
-  // } else if (dom_constraint_mode == "enforce") {
+    DOMConstraintIndex *dom_constraint_index = element->GetDocument().GetFrame()->GetDOMConstraintIndex();
+    Element *shadow_ptr = dom_constraint_index->Tree().GetElement(shadow_id);
+    AtomicString current_value = dom_constraint_index->Overlay().Current(shadow_ptr)->getAttribute(name);
+    AtomicString merged_value = mergeShadowAttribute(shadow_ptr, name.LocalName(), current_value, new_value);
+    if (merged_value != current_value) {
+      dom_constraint_index->Overlay().EnsureWritable(shadow_ptr)->setAttribute(name, merged_value);
+      dom_constraint_index->DidChangeShadowAttributes(shadow_id);
+    }
+  } else {
     ShadowTreeMatchResult match_result = ShadowTreeMatchResult::NotFound;
-    Element *shadow_ptr = DynamicTo<Element>(locateNodeInShadowTree(element, match_result));
+    DOMConstraintTree::NodeId shadow_id = locateNodeInShadowTree(element, match_result);
+    DOMConstraintTree& tree = element->GetDocument().GetFrame()->GetDOMConstraintIndex()->Tree();
 
     if (match_result == ShadowTreeMatchResult::RootIsNotDocument) {
       allowed = true;
     } else if (match_result == ShadowTreeMatchResult::Found) {
-      allowed = attributeEquals(element, name.LocalName(), shadow_ptr->getAttribute(name), new_value);
+      allowed = attributeEquals(element, name.LocalName(), tree.Pattern(shadow_id, name.LocalName()), new_value);
     } else if (match_result == ShadowTreeMatchResult::WhitelistMatch) {
-      allowed = matchesAttributeWhitelistInShadowTree(element, name.LocalName(), new_value, shadow_ptr);
+      allowed = matchesAttributeWhitelistInShadowTree(element, name.LocalName(), new_value, shadow_id);
     } else {
       allowed = false;
     }
     if (!allowed) {
-      LOG(INFO) << "ModifyDOMAttr rejected, match_result = " << match_result << ", attribute_name = " << name.LocalName().Utf8() << ", attribute_value = " << new_value.Utf8() << ", allowed_values = " << shadow_ptr->getAttribute(name).Utf8();
+      LOG(INFO) << "ModifyDOMAttr rejected, match_result = " << match_result << ", attribute_name = " << name.LocalName().Utf8() << ", attribute_value = " << new_value.Utf8() << ", allowed_values = " << (match_result == ShadowTreeMatchResult::Found ? tree.Attribute(shadow_id, name.LocalName()).Utf8() : "");
       element->PrintNodePathTo(LOG_STREAM(INFO));
     }
   }
@@ -923,83 +1213,152 @@ void DOMGuard::WillRemoveDOMNodeExtended(Node* node, bool &allowed) {
     return;
   }
 
-  if (isDescendantOfUserAgentShadowRoot(node)) {
+  if (node->IsInUserAgentShadowTree()) {
     return;
   }
 }
 
-void DOMGuard::collectStyleChanges(Element *element, const ComputedStyle* current_style, const ComputedStyle* new_style, bool is_whitelist_match = true) {
-  int count = -1;
+const AtomicString& DOMGuard::newCssText(wtf_size_t index) {
+  AtomicString& new_css_text = css_property_texts_[index];
+  if (new_css_text.IsNull()) {
+    const CSSValue* new_value = css_property_values_[index];
+    new_css_text = new_value ? AtomicString(new_value->CssText()) : g_empty_atom;
+  }
+  return new_css_text;
+}
+
+void DOMGuard::collectStyleChanges(Element *element, const ComputedStyle* current_style, const ComputedStyle* new_style) {
+  for (wtf_size_t index : modified_property_indices_) {
+    is_css_property_modified_[index] = false;
+    css_property_values_[index] = nullptr;
+    css_property_texts_[index] = g_null_atom;
+  }
+  modified_property_indices_.clear();
   modified_property_count_ = 0;
-  for (CSSPropertyID property_id : css_property_ids_) {
-    count += 1;
-    is_css_property_modified_[count] = false;
-    const CSSProperty& property = CSSProperty::Get(ResolveCSSPropertyID(property_id));
-    const CSSValue* new_css_value = ComputedStyleUtils::ComputedPropertyValue(property, *new_style);
-    if (is_whitelist_match) {
-      css_property_values_[count] = const_cast<CSSValue *>(new_css_value);
-    }
+  if (!current_style) {
+    collectFirstStyle(*new_style);
+    return;
+  }
+  // Most recalcs leave the style as it was; the field groups are shared and compared by pointer first, so this is
+  // much cheaper than looking at every property.
+  if (*current_style == *new_style) {
+    return;
+  }
+
+  // The inherited fields (color, zoom, font) also go into the computed values of non-inherited properties, so those
+  // can only be skipped along with the inherited ones.
+  bool inherited_equal = current_style->InheritedEqual(*new_style);
+  if (!inherited_equal) {
+    collectStyleChanges(inherited_property_indices_, *current_style, *new_style);
+  }
+  if (!inherited_equal || !current_style->NonInheritedEqual(*new_style)) {
+    collectStyleChanges(non_inherited_property_indices_, *current_style, *new_style);
+  }
+}
 
-    if (!current_style) {
+void DOMGuard::collectStyleChanges(const Vector<wtf_size_t>& indices, const ComputedStyle& current_style, const ComputedStyle& new_style) {
+  for (wtf_size_t index : indices) {
+    const CSSProperty& property = CSSProperty::Get(ResolveCSSPropertyID(css_property_ids_[index]));
+    int fast_match_result = CSSPropertyEquality::PropertiesEqualForDOMGuard(PropertyHandle(property), current_style, new_style); 
+    if (fast_match_result == 1) {
+      continue;
+    }
+    const CSSValue* new_css_value = ComputedStyleUtils::ComputedPropertyValue(property, new_style);
+    if (fast_match_result == -1) {
+      const CSSValue* current_css_value = ComputedStyleUtils::ComputedPropertyValue(property, current_style);
+      String current_css_text = current_css_value ? current_css_value->CssText() : "";
       String new_css_text = new_css_value ? new_css_value->CssText() : "";
 
-      if (new_css_text != "") {
-        is_css_property_modified_[count] = true;
-        modified_property_count_ += 1;
+      if (current_css_text == new_css_text) {
+        continue;
       }
-    } else {
-      int fast_match_result = CSSPropertyEquality::PropertiesEqualForDOMGuard(PropertyHandle(property), *current_style, *new_style); 
-      if (fast_match_result == 0) {
-        is_css_property_modified_[count] = true;
-        modified_property_count_ += 1;
-      } else if (fast_match_result == -1) {
-        const CSSValue* current_css_value = ComputedStyleUtils::ComputedPropertyValue(property, *current_style);
-        String current_css_text = current_css_value ? current_css_value->CssText() : "";
-        String new_css_text = new_css_value ? new_css_value->CssText() : "";
-
-        if (current_css_text != new_css_text) {
-          is_css_property_modified_[count] = true;
-          modified_property_count_ += 1;
-        }
-      }     
     }
+    markPropertyModified(index, new_css_value);
   }
 }
 
+// An element's first style counts every property with a value as modified. Elements get their first style in bulk and
+// mostly from the same rules, so the values found for the previous first style are kept, and only the properties whose
+// fields differ from it are serialized again.
+void DOMGuard::collectFirstStyle(const ComputedStyle& new_style) {
+  const ComputedStyle* first_style = first_style_.get();
+  bool inherited_equal = first_style && first_style->InheritedEqual(new_style);
+  bool non_inherited_equal = inherited_equal && first_style->NonInheritedEqual(new_style);
+  for (wtf_size_t index = 0; index < css_property_ids_.size(); ++index) {
+    const CSSProperty& property = CSSProperty::Get(ResolveCSSPropertyID(css_property_ids_[index]));
+    // The field comparators do not see what a value resolves against (currentcolor, zoom), so they are only trusted
+    // while the inherited fields are the same.
+    bool is_equal = inherited_equal && (property.IsInherited() || non_inherited_equal || CSSPropertyEquality::PropertiesEqualForDOMGuard(PropertyHandle(property), *first_style, new_style) == 1);
+    if (!is_equal) {
+      const CSSValue* new_css_value = ComputedStyleUtils::ComputedPropertyValue(property, new_style);
+      AtomicString new_css_text = new_css_value ? AtomicString(new_css_value->CssText()) : g_empty_atom;
+      first_style_values_[index] = new_css_text.IsEmpty() ? nullptr : new_css_value;
+      first_style_texts_[index] = new_css_text;
+    }
+    if (first_style_values_[index]) {
+      markPropertyModified(index, first_style_values_[index]);
+      css_property_texts_[index] = first_style_texts_[index];
+    }
+  }
+  first_style_ = &new_style;
+}
+
+void DOMGuard::markPropertyModified(wtf_size_t index, const CSSValue* new_css_value) {
+  is_css_property_modified_[index] = true;
+  css_property_values_[index] = const_cast<CSSValue *>(new_css_value);
+  modified_property_indices_.push_back(index);
+  modified_property_count_ += 1;
+}
+
 void DOMGuard::WillSetStyle(Element* element, const ComputedStyle* style, bool& allowed) {
   allowed = true;
-  if (!element->GetDocument().domWindow()) { // Moving an element into a DOMWindow always triggers WillSetStyle
+  LocalFrame *frame = element->GetDocument().GetFrame();
+  if (!frame) { // Moving an element into a DOMWindow always triggers WillSetStyle
     return;
   }
+  (this->*frame->GetDOMGuardProbes().will_set_style)(element, style, allowed);
+}
+
+template <>
+void DOMGuard::willSetStyle<DOMConstraintConfig::Mode::kIdle>(Element* element, const ComputedStyle* style, bool& allowed) {}
 
-  if (isDescendantOfUserAgentShadowRoot(element)) {
+template <DOMConstraintConfig::Mode mode>
+void DOMGuard::willSetStyle(Element* element, const ComputedStyle* style, bool& allowed) {
+  if (element->IsInUserAgentShadowTree()) {
     return;
   }
 
-  String dom_constraint_mode = element->GetDocument().GetFrame()->DOMConstraintMode();
-  if (dom_constraint_mode.length() && dom_constraint_mode[0] == 'r') {
+  if (mode == DOMConstraintConfig::Mode::kRecord) {
     ShadowTreeMatchResult match_result = ShadowTreeMatchResult::NotFound;
-    Element *shadow_ptr = DynamicTo<Element>(locateNodeAndCreateAncestorsInShadowTree(element, match_result));
+    DOMConstraintTree::NodeId shadow_id = locateNodeAndCreateAncestorsInShadowTree(element, match_result);
     if (match_result != ShadowTreeMatchResult::Found) {
       return;
     }
 
+    DOMConstraintIndex *dom_constraint_index = element->GetDocument().GetFrame()->GetDOMConstraintIndex();
+    DOMConstraintOverlay& overlay = dom_constraint_index->Overlay();
+    Element *shadow_ptr = dom_constraint_index->Tree().GetElement(shadow_id);
     const ComputedStyle* current_style = element->GetComputedStyle();
-    collectStyleChanges(element, current_style, style, false);
-    int count = 0;
-    for (CSSPropertyID property_id : css_property_ids_) {
-      if (is_css_property_modified_[count]) {
-        const CSSProperty& property = CSSProperty::Get(ResolveCSSPropertyID(property_id));
-        AtomicString shadow_attribute_name = "dtt-s-" + property.GetPropertyNameString();
-        const CSSValue* new_css_value = ComputedStyleUtils::ComputedPropertyValue(property, *style);
-        shadow_ptr->setAttribute(shadow_attribute_name, mergeShadowProperty(shadow_ptr, property, shadow_ptr->getAttribute(shadow_attribute_name), new_css_value, element->GetDocument().ElementSheet().Contents()->ParserContext()));
+    collectStyleChanges(element, current_style, style);
+    bool changed = false;
+    for (wtf_size_t index : modified_property_indices_) {
+      const CSSProperty& property = CSSProperty::Get(ResolveCSSPropertyID(css_property_ids_[index]));
+      AtomicString shadow_attribute_name = "dtt-s-" + property.GetPropertyNameString();
+      AtomicString current_value = overlay.Current(shadow_ptr)->getAttribute(shadow_attribute_name);
+      AtomicString merged_value = mergeShadowProperty(element, property, dom_constraint_index->Tree().Pattern(shadow_id, shadow_attribute_name), css_property_values_[index], element->GetDocument().ElementSheet().Contents()->ParserContext());
+      if (merged_value != current_value) {
+        overlay.EnsureWritable(shadow_ptr)->setAttribute(shadow_attribute_name, merged_value);
+        changed = true;
       }
-      count += 1;
     }
-  } else if (dom_constraint_mode.length() && dom_constraint_mode[0] == 'e') {
+    // Every property has an attribute of its own, so the tree only needs to catch up once all of them are written.
+    if (changed) {
+      dom_constraint_index->DidChangeShadowAttributes(shadow_id);
+    }
+  } else {
     ShadowTreeMatchResult match_result = ShadowTreeMatchResult::NotFound;
-    Element *shadow_ptr = DynamicTo<Element>(locateNodeInShadowTree(element, match_result));
-    if (!shadow_ptr) {
+    DOMConstraintTree::NodeId shadow_id = locateNodeInShadowTree(element, match_result);
+    if (shadow_id == kNotFound) {
       allowed = false;
       return;
     }
@@ -1007,28 +1366,13 @@ void DOMGuard::WillSetStyle(Element* element, const ComputedStyle* style, bool&
     if (match_result == ShadowTreeMatchResult::RootIsNotDocument) {
       allowed = true;
     } else if (match_result == ShadowTreeMatchResult::Found) {
+      DOMConstraintIndex *dom_constraint_index = element->GetDocument().GetFrame()->GetDOMConstraintIndex();
+      Element *shadow_ptr = dom_constraint_index->Tree().GetElement(shadow_id);
       const ComputedStyle* current_style = element->GetComputedStyle();
-      for (CSSPropertyID property_id : css_property_ids_) {
-        const CSSProperty& property = CSSProperty::Get(ResolveCSSPropertyID(property_id));
-        const CSSValue* new_value = ComputedStyleUtils::ComputedPropertyValue(property, *style);
-        String new_css_text = new_value ? new_value->CssText() : "";
-        if (!current_style) {
-          if (new_css_text == "") {
-            continue;
-          }
-        } else {
-          int fast_match_result_current = CSSPropertyEquality::PropertiesEqualForDOMGuard(PropertyHandle(property), *current_style, *style);
-          if (fast_match_result_current == 1) {
-            continue;
-          } else if (fast_match_result_current == -1) {
-            const CSSValue* current_css_value = ComputedStyleUtils::ComputedPropertyValue(property, *current_style);
-            String current_css_text = current_css_value ? current_css_value->CssText() : "";
-
-            if (current_css_text == new_css_text) {
-              continue;
-            }
-          }
-        }
+      collectStyleChanges(element, current_style, style);
+      for (wtf_size_t index : modified_property_indices_) {
+        const CSSProperty& property = CSSProperty::Get(ResolveCSSPropertyID(css_property_ids_[index]));
+        const CSSValue* new_value = css_property_values_[index];
         const ComputedStyle* shadow_computed_style = shadow_ptr->GetComputedStyle();
         if (shadow_computed_style) {
           int fast_match_result_shadow = CSSPropertyEquality::PropertiesEqualForDOMGuard(PropertyHandle(property), *shadow_computed_style, *style); 
@@ -1036,38 +1380,32 @@ void DOMGuard::WillSetStyle(Element* element, const ComputedStyle* style, bool&
             continue;
           }
 
-          const CSSValue* shadow_css_value = ComputedStyleUtils::ComputedPropertyValue(property, *shadow_computed_style);
-          String shadow_css_text = shadow_css_value ? shadow_css_value->CssText() : "";
-
-          if (shadow_css_text == new_css_text) {
+          if (dom_constraint_index->ShadowStyleText(shadow_ptr, property) == newCssText(index)) {
             continue;
           }
         }
         AtomicString shadow_attribute_name = "dtt-s-" + property.GetPropertyNameString();
-        allowed &= propertyEquals(element, property, shadow_ptr->getAttribute(shadow_attribute_name), new_value, element->GetDocument().ElementSheet().Contents()->ParserContext());
+        allowed &= propertyEquals(element, property, dom_constraint_index->Tree().Pattern(shadow_id, shadow_attribute_name), new_value, element->GetDocument().ElementSheet().Contents()->ParserContext());
         if (!allowed) {
-          LOG(INFO) << "SetStyle rejected, match_result = " << match_result << ", property = " << property.GetPropertyNameString().Utf8() << ", value = " << (new_value ? new_value->CssText().Utf8() : "") << ", allowed_values = " << shadow_ptr->getAttribute(shadow_attribute_name).Utf8();
+          LOG(INFO) << "SetStyle rejected, match_result = " << match_result << ", property = " << property.GetPropertyNameString().Utf8() << ", value = " << (new_value ? new_value->CssText().Utf8() : "") << ", allowed_values = " << dom_constraint_index->Tree().Attribute(shadow_id, shadow_attribute_name).Utf8();
           element->PrintNodePathTo(LOG_STREAM(INFO));
           return;
         }
       }
     } else if (match_result == ShadowTreeMatchResult::WhitelistMatch) {
       const ComputedStyle* current_style = element->GetComputedStyle();
-      collectStyleChanges(element, current_style, style, true);
-      allowed = matchesPropertyWhitelistInShadowTree(element, shadow_ptr, style, false);
+      collectStyleChanges(element, current_style, style);
+      allowed = matchesPropertyWhitelistInShadowTree(element, shadow_id, style, false);
       if (!allowed) {
-        allowed = matchesPropertyWhitelistInShadowTree(element, shadow_ptr, style, true);
+        allowed = matchesPropertyWhitelistInShadowTree(element, shadow_id, style, true);
       }
       if (!allowed) {
-        int count = 0;
-        for (CSSPropertyID property_id : css_property_ids_) {
-          if (is_css_property_modified_[count]) {
-            const CSSProperty& property = CSSProperty::Get(ResolveCSSPropertyID(property_id));
-            AtomicString shadow_attribute_name = "dtt-s-" + property.GetPropertyNameString();
-            const CSSValue* new_value = ComputedStyleUtils::ComputedPropertyValue(property, *style);
+        for (wtf_size_t index : modified_property_indices_) {
+          if (is_css_property_modified_[index]) {
+            const CSSProperty& property = CSSProperty::Get(ResolveCSSPropertyID(css_property_ids_[index]));
+            const CSSValue* new_value = css_property_values_[index];
             LOG(INFO) << "SetStyle rejected, match_result = " << match_result << ", property = " << property.GetPropertyNameString().Utf8() << ", value = " << (new_value ? new_value->CssText().Utf8() : "");
           }
-          count += 1;
         }
         element->PrintNodePathTo(LOG_STREAM(INFO));
       }
@@ -1079,16 +1417,44 @@ void DOMGuard::WillSetStyle(Element* element, const ComputedStyle* style, bool&
   }
 }
 
+const DOMGuardProbes& DOMGuard::ProbesFor(DOMConstraintConfig::Mode mode) {
+  using Mode = DOMConstraintConfig::Mode;
+  static const DOMGuardProbes kIdleProbes = {&DOMGuard::willInsertDOMNode<Mode::kIdle>, &DOMGuard::willModifyDOMAttr<Mode::kIdle>, &DOMGuard::willSetStyle<Mode::kIdle>};
+  static const DOMGuardProbes kRecordProbes = {&DOMGuard::willInsertDOMNode<Mode::kRecord>, &DOMGuard::willModifyDOMAttr<Mode::kRecord>, &DOMGuard::willSetStyle<Mode::kRecord>};
+  static const DOMGuardProbes kEnforceProbes = {&DOMGuard::willInsertDOMNode<Mode::kEnforce>, &DOMGuard::willModifyDOMAttr<Mode::kEnforce>, &DOMGuard::willSetStyle<Mode::kEnforce>};
+  switch (mode) {
+    case Mode::kRecord:
+      return kRecordProbes;
+    case Mode::kEnforce:
+      return kEnforceProbes;
+    case Mode::kIdle:
+      break;
+  }
+  return kIdleProbes;
+}
+
 void DOMGuard::FrameAttachedToParent(LocalFrame* frame) {
   modified_property_count_ = 0;
+  modified_property_indices_.clear();
   css_property_ids_.clear();
   is_css_property_modified_.clear();
+  css_property_values_.clear();
+  css_property_texts_.clear();
+  inherited_property_indices_.clear();
+  non_inherited_property_indices_.clear();
+  first_style_ = nullptr;
+  first_style_values_.clear();
+  first_style_texts_.clear();
   for (CSSPropertyID property_id : CSSPropertyIDList()) {
     const CSSProperty& property = CSSProperty::Get(ResolveCSSPropertyID(property_id));
     if (property.IsWebExposed(frame->DomWindow()) && !property.IsShorthand() && property.IsProperty() && !property.IsLayoutDependentProperty() && !property.IsInternal() && !property.IsSurrogate()) {
+      (property.IsInherited() ? inherited_property_indices_ : non_inherited_property_indices_).push_back(css_property_ids_.size());
       css_property_ids_.push_back(property_id);
+      first_style_values_.push_back(nullptr);
+      first_style_texts_.push_back(g_null_atom);
       is_css_property_modified_.push_back(false);
       css_property_values_.push_back(nullptr);
+      css_property_texts_.push_back(g_null_atom);
     }
   }
   frame->SetDOMConstraintHTML("");
@@ -1118,6 +1484,7 @@ void DOMGuard::Did(const probe::ParseHTML& probe) {
 void DOMGuard::Trace(Visitor* visitor) const {
   visitor->Trace(local_root_);
   visitor->Trace(css_property_values_);
+  visitor->Trace(first_style_values_);
 }
 
 DOMGuard::DOMGuard(LocalFrame* local_root)
@@ -1155,27 +1522,25 @@ void DOMGuard::outputPropertyModification(Element* shadow_element, const String&
   shadow_element->PrintNodePathTo(LOG_STREAM(INFO));
 }
 
+// Only descends into subtrees that Node::MarkAncestorsWithChildHasPendingAttributeChanges() marked.
 void DOMGuard::executePendingAttributeChanges(Node *node) {
-  auto *document_fragment = DynamicTo<DocumentFragment>(node);
-  if (document_fragment) {
-    for (auto *child = node->firstChild(); child; child = child->nextSibling()) {
-      executePendingAttributeChanges(child);
-    }
+  Element *element = DynamicTo<Element>(node);
+  if (element) {
+    element->ExecutePendingAttributeChanges();
+  } else if (!DynamicTo<DocumentFragment>(node)) {
     return;
   }
 
-  Element *element = DynamicTo<Element>(node);
-  if (!element) {
+  if (!node->ChildHasPendingAttributeChanges()) {
     return;
   }
-
-  element->ExecutePendingAttributeChanges();
+  node->ClearChildHasPendingAttributeChanges();
 
   for (auto *child = node->firstChild(); child; child = child->nextSibling()) {
     executePendingAttributeChanges(child);
   }
 
-  ShadowRoot *shadow_root = element->AuthorShadowRoot();
+  ShadowRoot *shadow_root = element ? element->AuthorShadowRoot() : nullptr;
   if (shadow_root) {
     executePendingAttributeChanges(shadow_root);
   }
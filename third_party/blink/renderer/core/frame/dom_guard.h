@@ -5,14 +5,26 @@
 #ifndef THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_GUARD_H_
 #define THIRD_PARTY_BLINK_RENDERER_CORE_FRAME_DOM_GUARD_H_
 
+#include <memory>
+
 #include "base/feature_list.h"
 #include "base/macros.h"
+#include "base/memory/scoped_refptr.h"
 #include "third_party/blink/renderer/core/core_export.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_config.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_index.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_pattern.h"
 #include "third_party/blink/renderer/platform/heap/handle.h"
 #include "third_party/blink/renderer/platform/weborigin/kurl.h"
+#include "third_party/blink/renderer/platform/wtf/hash_map.h"
 #include "third_party/blink/renderer/platform/wtf/hash_set.h"
 #include "third_party/blink/renderer/platform/wtf/text/atomic_string_hash.h"
 
+namespace v8_scanner {
+class ReusableScanner;
+class Scanner;
+}  // namespace v8_scanner
+
 namespace blink {
 
 class ComputedStyle;
@@ -21,6 +33,7 @@ enum class CSSPropertyID;
 class CSSValue;
 class CSSProperty;
 class Document;
+class DOMConstraintIndex;
 class Element;
 enum class FrameDetachType;
 class LocalFrame;
@@ -34,6 +47,18 @@ namespace probe {
   class ParseHTML;
 }  // namespace probe
 
+class DOMGuard;
+
+// The DOMGuard probe paths for one DOMConstraintConfig::Mode. Every frame
+// holds the table for its mode, which LocalFrame::SetDOMConstraintMode()
+// swaps, so a probe makes one indirect call instead of testing the mode, and
+// a frame that neither records nor enforces skips the guard altogether.
+struct DOMGuardProbes {
+  void (DOMGuard::*will_insert_dom_node)(Node*, Node*, Node*, bool&);
+  void (DOMGuard::*will_modify_dom_attr)(Element*, const QualifiedName&, const AtomicString&, const AtomicString&, bool&);
+  void (DOMGuard::*will_set_style)(Element*, const ComputedStyle*, bool&);
+};
+
 class CORE_EXPORT DOMGuard : public GarbageCollected<DOMGuard> {
  public:
   void WillInsertDOMNodeExtended(Node*, Node*, Node*, bool&);
@@ -46,6 +71,8 @@ class CORE_EXPORT DOMGuard : public GarbageCollected<DOMGuard> {
   void Will(const probe::ParseHTML& probe);
   void Did(const probe::ParseHTML& probe);
 
+  static const DOMGuardProbes& ProbesFor(DOMConstraintConfig::Mode);
+
   virtual void Trace(Visitor*) const;
 
   void Shutdown();
@@ -62,35 +89,69 @@ private:
     WhitelistMatch = 3,
   };
 
+  // An element of a subtree that is about to be inserted, with the enforce
+  // mode binding it gets once the insertion is allowed (|shadow_node| is
+  // kNotFound if it gets none).
+  struct InsertedElement {
+    DISALLOW_NEW();
+
+   public:
+    void Trace(Visitor* visitor) const { visitor->Trace(element); }
+
+    Member<Element> element;
+    DOMConstraintTree::NodeId shadow_node;
+    ShadowTreeMatchResult match_result;
+  };
+
+  template <DOMConstraintConfig::Mode>
+  void willInsertDOMNode(Node*, Node*, Node*, bool&);
+  template <DOMConstraintConfig::Mode>
+  void willModifyDOMAttr(Element*, const QualifiedName&, const AtomicString&, const AtomicString&, bool&);
+  template <DOMConstraintConfig::Mode>
+  void willSetStyle(Element*, const ComputedStyle*, bool&);
+
   bool stringEquals(const String&, wtf_size_t, const String&, wtf_size_t);
   bool stringEquals(const AtomicString&, wtf_size_t, const AtomicString&, wtf_size_t);
+  ::v8_scanner::ReusableScanner& scriptScanner(std::unique_ptr<::v8_scanner::ReusableScanner>&);
   bool scriptEquals(const String& shadow_string, const String& actual_string);
-  bool idEquals(const AtomicString&, const AtomicString&, const String&);
+  bool idEquals(const AtomicString&, const AtomicString&, const DOMConstraintConfig&);
+  const DOMConstraintConfig& constraintConfig(const Node*);
   bool attributeEquals(Element*, const AtomicString&, const AtomicString&, const AtomicString&);
-  void cssValueEquals(const CSSProperty&, const CSSValue*, const CSSValue*, const CSSParserContext*, int&);
-  void cssValueEquals(const CSSProperty&, const String&, const CSSValue*, const CSSParserContext*, int&);
-  bool propertyEquals(Element*, const CSSProperty&, const AtomicString&, const CSSValue*, const CSSParserContext*);
+  bool attributeEquals(Element*, const AtomicString&, DOMConstraintPattern&, const AtomicString&);
+  bool cssValueEquals(const CSSProperty&, const CSSValue*, const CSSValue*, const CSSParserContext*);
+  bool propertyEquals(Element*, const CSSProperty&, DOMConstraintPattern&, const CSSValue*, const CSSParserContext*);
   bool urlEquals(const KURL&, const KURL&);
   bool urlEquals(const Vector<KURL>&, const KURL&);
 
-  Node* locateNodeInShadowTree(Node*, ShadowTreeMatchResult&);
-  Node* locateNodeAndCreateAncestorsInShadowTree(Node*, ShadowTreeMatchResult&);
-  void createShadowNode(Document*, Element*, Node*);
+  DOMConstraintTree::NodeId locateNodeInShadowTree(Node*, ShadowTreeMatchResult&);
+  DOMConstraintTree::NodeId locateNodeAndCreateAncestorsInShadowTree(Node*, ShadowTreeMatchResult&);
+  void createShadowNode(DOMConstraintIndex*, DOMConstraintTree::NodeId, Node*);
   bool shouldMonitorAttribute(const Element*, const QualifiedName&);
   bool isScriptAttribute(const Element*, const AtomicString&);
   bool isURLAttribute(const Element*, const AtomicString&);
-  bool isEqualInShadowTree(Element*, Element*);
+  bool isEqualInShadowTree(DOMConstraintTree&, DOMConstraintTree::NodeId, Element*);
+  bool hasIdPrefixInMode(Element*, const AtomicString&);
+  DOMConstraintTree::NodeId findShadowChild(DOMConstraintIndex*, DOMConstraintTree::NodeId, Element*);
   AtomicString escapeAndAddToAttributeValue(const AtomicString&, const AtomicString&);
+  AtomicString generalizeShadowValue(const AtomicString&);
   AtomicString mergeShadowAttribute(Element*, const AtomicString&, const AtomicString&, const AtomicString&);
-  AtomicString mergeShadowProperty(Element*, const CSSProperty&, const AtomicString&, const CSSValue*, const CSSParserContext*);
-  bool hasMatchingSubtreeInShadowTree(Node*, Node*);
-  bool hasMatchingNodeInShadowTree(Node*, Node*);
-  bool matchesNodeWhitelistInShadowTree(Node*, Node*);
-  bool matchesAttributeWhitelistInShadowTree(Element*, const AtomicString&, const AtomicString&, Node*);
-  bool matchesPropertyWhitelistInShadowTree(Element*, Element*, const ComputedStyle*, bool);
-  Node* matchingNode(Node*, Node*);
-  bool isDescendantOfUserAgentShadowRoot(Node*);
-  void collectStyleChanges(Element*, const ComputedStyle*, const ComputedStyle*, bool);
+  AtomicString mergeShadowProperty(Element*, const CSSProperty&, DOMConstraintPattern&, const CSSValue*, const CSSParserContext*);
+  DOMConstraintTree::NodeId matchingChildInShadowTree(DOMConstraintIndex*, Element*, DOMConstraintTree::NodeId);
+  bool hasMatchingNodeInShadowTree(Node*, DOMConstraintTree::NodeId);
+  bool hasMatchingNodeInShadowTree(DOMConstraintTree&, const ShadowSubtreeSummary::ElementKeys&, Element*, DOMConstraintTree::NodeId);
+  bool validateInsertedSubtree(DOMConstraintIndex*, Node*, DOMConstraintTree::NodeId, ShadowTreeMatchResult, DOMConstraintTree::NodeId, ShadowTreeMatchResult, HeapVector<InsertedElement>&);
+  void collectInsertedElements(Node*, HeapVector<InsertedElement>&);
+  void commitInsertedElements(DOMConstraintIndex*, const HeapVector<InsertedElement>&);
+  bool matchesAttributeWhitelistInShadowTree(Element*, const AtomicString&, const AtomicString&, DOMConstraintTree::NodeId);
+  bool matchesAttributeWhitelistInShadowTree(DOMConstraintTree&, Element*, const AtomicString&, const AtomicString&, unsigned, DOMConstraintTree::NodeId);
+  bool matchesPropertyWhitelistInShadowTree(Element*, DOMConstraintTree::NodeId, const ComputedStyle*, bool);
+  bool matchesPropertyWhitelistInShadowTree(DOMConstraintIndex*, Element*, DOMConstraintTree::NodeId, const ComputedStyle*, bool);
+  bool matchingNode(DOMConstraintTree&, Element*, DOMConstraintTree::NodeId);
+  void collectStyleChanges(Element*, const ComputedStyle*, const ComputedStyle*);
+  void collectStyleChanges(const Vector<wtf_size_t>&, const ComputedStyle&, const ComputedStyle&);
+  void collectFirstStyle(const ComputedStyle&);
+  void markPropertyModified(wtf_size_t, const CSSValue*);
+  const AtomicString& newCssText(wtf_size_t);
 
   void outputElementInsertion(Element*, Element*);
   void outputAttributeModification(Element*, const AtomicString&, const AtomicString&);
@@ -101,8 +162,27 @@ private:
   Member<LocalFrame> local_root_;
   Vector<CSSPropertyID> css_property_ids_;
   HeapVector<Member<CSSValue>> css_property_values_;
+  // Interned CssText() of css_property_values_, serialized on first use.
+  Vector<AtomicString> css_property_texts_;
   Vector<bool> is_css_property_modified_;
+  // Indices into css_property_ids_ of the properties the last collectStyleChanges() found modified, so that later
+  // passes only visit those.
+  Vector<wtf_size_t> modified_property_indices_;
   int modified_property_count_;
+  // Indices into css_property_ids_ of the inherited and the other properties, so that a style change only visits the
+  // properties of the field groups that changed.
+  Vector<wtf_size_t> inherited_property_indices_;
+  Vector<wtf_size_t> non_inherited_property_indices_;
+  // The last style collectFirstStyle() saw, with the values and interned texts it found for it (nullptr for the
+  // properties it skips), indexed like css_property_ids_.
+  scoped_refptr<const ComputedStyle> first_style_;
+  HeapVector<Member<const CSSValue>> first_style_values_;
+  Vector<AtomicString> first_style_texts_;
+  // Reused by every scriptEquals() call instead of being built per comparison.
+  std::unique_ptr<::v8_scanner::ReusableScanner> shadow_script_scanner_;
+  std::unique_ptr<::v8_scanner::ReusableScanner> actual_script_scanner_;
+  // Token buffer for the handler being checked, kept to avoid reallocating it.
+  ScriptTokenSequence actual_script_tokens_;
 };
 
 }  // namespace blink
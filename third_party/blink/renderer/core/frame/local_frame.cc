@@ -100,6 +100,9 @@
 #include "third_party/blink/renderer/core/fileapi/public_url_manager.h"
 #include "third_party/blink/renderer/core/frame/ad_tracker.h"
 #include "third_party/blink/renderer/core/frame/csp/content_security_policy.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_config.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_index.h"
+#include "third_party/blink/renderer/core/frame/dom_constraint_serialization.h"
 #include "third_party/blink/renderer/core/frame/dom_guard.h"
 #include "third_party/blink/renderer/core/frame/event_handler_registry.h"
 #include "third_party/blink/renderer/core/frame/frame_console.h"
@@ -219,6 +222,16 @@ static LocalFramesByTokenMap& GetLocalFramesMap() {
   return *map;
 }
 
+// Constraint documents loaded from shared memory, keyed by the GUID of their
+// region, so that all frames of this renderer that are handed the same region
+// share one document instead of each parsing and styling a copy.
+using SharedDOMConstraintMap = HeapHashMap<String, WeakMember<Document>>;
+static SharedDOMConstraintMap& GetSharedDOMConstraints() {
+  DEFINE_STATIC_LOCAL(Persistent<SharedDOMConstraintMap>, map,
+                      (MakeGarbageCollected<SharedDOMConstraintMap>()));
+  return *map;
+}
+
 // Maximum number of burst download requests allowed.
 const int kBurstDownloadLimit = 10;
 
@@ -546,6 +559,8 @@ void LocalFrame::Trace(Visitor* visitor) const {
   visitor->Trace(dom_window_);
   visitor->Trace(page_popup_owner_);
   visitor->Trace(dom_constraint_);
+  visitor->Trace(dom_constraint_index_);
+  visitor->Trace(dom_constraint_config_);
   visitor->Trace(editor_);
   visitor->Trace(selection_);
   visitor->Trace(event_handler_);
@@ -928,8 +943,9 @@ void LocalFrame::SetPagePopupOwner(Element& owner) {
   page_popup_owner_ = &owner;
 }
 
-void LocalFrame::SetDOMConstraint(Document& dom_constraint) {
+void LocalFrame::SetDOMConstraint(Document& dom_constraint, bool is_shared) {
   dom_constraint_ = &dom_constraint;
+  dom_constraint_index_ = MakeGarbageCollected<DOMConstraintIndex>(dom_constraint, is_shared);
 }
 
 LayoutView* LocalFrame::ContentLayoutObject() const {
@@ -1528,6 +1544,8 @@ LocalFrame::LocalFrame(LocalFrameClient* client,
           IsMainFrame() ? FrameScheduler::FrameType::kMainFrame
                         : FrameScheduler::FrameType::kSubframe)),
       loader_(this),
+      dom_constraint_config_(MakeGarbageCollected<DOMConstraintConfig>(String())),
+      dom_guard_probes_(&DOMGuard::ProbesFor(DOMConstraintConfig::Mode::kIdle)),
       editor_(MakeGarbageCollected<Editor>(*this)),
       selection_(MakeGarbageCollected<FrameSelection>(*this)),
       event_handler_(MakeGarbageCollected<EventHandler>(*this)),
@@ -3508,22 +3526,103 @@ void LocalFrame::SetDOMConstraintHTML(const WTF::String& dom_constraint_html) {
   }
   CalculateStyle(doc);
     
-  SetDOMConstraint(*doc);
+  SetDOMConstraint(*doc, false);
+}
+
+Document* LocalFrame::LoadDOMConstraintData(const base::ReadOnlySharedMemoryRegion& dom_constraint_data) {
+  base::ReadOnlySharedMemoryMapping mapping = dom_constraint_data.Map();
+  if (!mapping.IsValid()) {
+    return nullptr;
+  }
+  // The binary form is already arranged, so only the styles are left to compute.
+  Document* doc = DeserializeDOMConstraint(base::make_span(static_cast<const uint8_t*>(mapping.memory()), mapping.size()));
+  if (!doc) {
+    LOG(ERROR) << "Malformed DOM constraint data";
+    return nullptr;
+  }
+  CalculateStyle(doc);
+  return doc;
+}
+
+void LocalFrame::SetDOMConstraintData(base::ReadOnlySharedMemoryRegion dom_constraint_data) {
+  SharedDOMConstraintMap& shared_constraints = GetSharedDOMConstraints();
+  String key = String::FromUTF8(dom_constraint_data.GetGUID().ToString());
+  Document* doc = nullptr;
+  auto it = shared_constraints.find(key);
+  if (it != shared_constraints.end()) {
+    doc = it->value.Get();
+  }
+  if (!doc) {
+    doc = LoadDOMConstraintData(dom_constraint_data);
+    if (!doc) {
+      return;
+    }
+    shared_constraints.Set(key, doc);
+  }
+  if (doc == dom_constraint_) {
+    return;
+  }
+
+  // The index stays per frame: its bindings point into this frame's DOM, and
+  // record mode writes to its overlay rather than to the shared document.
+  SetDOMConstraint(*doc, true);
 }
 
 void LocalFrame::SetDOMConstraintMode(const WTF::String& dom_constraint_mode) {
-  dom_constraint_mode_ = dom_constraint_mode;
+  dom_constraint_config_ = MakeGarbageCollected<DOMConstraintConfig>(dom_constraint_mode);
+  dom_guard_probes_ = &DOMGuard::ProbesFor(dom_constraint_config_->GetMode());
+  // Enforce mode only looks at the document, so whatever was recorded on top
+  // of a shared constraint is folded into a copy of its own first.
+  if (!dom_constraint_config_->IsRecording() && dom_constraint_index_ && !dom_constraint_index_->Overlay().IsEmpty()) {
+    Document* doc = dom_constraint_index_->Overlay().Fold(false);
+    CalculateStyle(doc);
+    SetDOMConstraint(*doc, false);
+    return;
+  }
+  // Id prefixes in the mode change how elements pair with shadow nodes.
+  if (dom_constraint_index_) {
+    dom_constraint_index_->ClearBindings();
+  }
+}
+
+void LocalFrame::DiscardDOMConstraintRecording() {
+  if (dom_constraint_index_ && dom_constraint_index_->Overlay().IsCopyOnWrite()) {
+    SetDOMConstraint(*dom_constraint_, true);
+  }
+}
+
+Document* LocalFrame::CurrentDOMConstraint() const {
+  if (!dom_constraint_index_ || dom_constraint_index_->Overlay().IsEmpty()) {
+    return dom_constraint_.Get();
+  }
+  return dom_constraint_index_->Overlay().Fold(false);
 }
 
 void LocalFrame::OutputDOMConstraintHTML() {
   LOG(INFO) << "BeginOutputDOMConstraintHTML";
-  std::string dom_constraint_html = CreateMarkup(dom_constraint_).Utf8();
+  std::string dom_constraint_html = CreateMarkup(CurrentDOMConstraint()).Utf8();
   for (unsigned int i = 0; i < dom_constraint_html.length(); i += 524288) {
     LOG(INFO) << dom_constraint_html.substr(i, 524288);
   }
   LOG(INFO) << "EndOutputDOMConstraintHTML";
 }
 
+void LocalFrame::GetDOMConstraintData(bool delta_only, GetDOMConstraintDataCallback callback) {
+  if (!dom_constraint_) {
+    std::move(callback).Run(base::ReadOnlySharedMemoryRegion());
+    return;
+  }
+  Document* doc = delta_only ? dom_constraint_index_->Overlay().Fold(true) : CurrentDOMConstraint();
+  Vector<uint8_t> dom_constraint_data = SerializeDOMConstraint(*doc);
+  base::MappedReadOnlyRegion region = base::ReadOnlySharedMemoryRegion::Create(dom_constraint_data.size());
+  if (!region.IsValid()) {
+    std::move(callback).Run(base::ReadOnlySharedMemoryRegion());
+    return;
+  }
+  memcpy(region.mapping.memory(), dom_constraint_data.data(), dom_constraint_data.size());
+  std::move(callback).Run(std::move(region.region));
+}
+
 bool LocalFrame::ShouldThrottleDownload() {
   const auto now = base::TimeTicks::Now();
   if (num_burst_download_requests_ == 0) {
@@ -32,6 +32,7 @@
 #include <memory>
 
 #include "base/macros.h"
+#include "base/memory/read_only_shared_memory_region.h"
 #include "base/time/default_tick_clock.h"
 #include "base/unguessable_token.h"
 #include "build/build_config.h"
@@ -108,7 +109,10 @@ class Color;
 class ContentCaptureManager;
 class CSSParser;
 class Document;
+class DOMConstraintConfig;
+class DOMConstraintIndex;
 class DOMGuard;
+struct DOMGuardProbes;
 class Editor;
 class Element;
 class EventHandler;
@@ -244,9 +248,15 @@ class CORE_EXPORT LocalFrame final
   void SetPagePopupOwner(Element&);
   Element* PagePopupOwner() const { return page_popup_owner_.Get(); }
 
-  void SetDOMConstraint(Document&);
+  // |is_shared| must be set if |dom_constraint| is also installed on other
+  // frames; record mode then leaves it untouched (see DOMConstraintOverlay).
+  void SetDOMConstraint(Document&, bool is_shared);
   Document* DOMConstraint() const { return dom_constraint_.Get(); }
-  String DOMConstraintMode() const { return dom_constraint_mode_; }
+  DOMConstraintIndex* GetDOMConstraintIndex() const { return dom_constraint_index_.Get(); }
+  // Parsed once by SetDOMConstraintMode(); never null.
+  const DOMConstraintConfig& GetDOMConstraintConfig() const { return *dom_constraint_config_; }
+  // The DOMGuard probe paths for the mode of GetDOMConstraintConfig().
+  const DOMGuardProbes& GetDOMGuardProbes() const { return *dom_guard_probes_; }
 
   // Root of the layout tree for the document contained in this frame.
   LayoutView* ContentLayoutObject() const;
@@ -679,8 +689,11 @@ class CORE_EXPORT LocalFrame final
       bool had_redirect,
       network::mojom::blink::SourceLocationPtr source_location) final;
   void SetDOMConstraintHTML(const WTF::String& dom_constraint_html) final;
+  void SetDOMConstraintData(base::ReadOnlySharedMemoryRegion dom_constraint_data) final;
   void SetDOMConstraintMode(const WTF::String& dom_constraint_mode) final;
   void OutputDOMConstraintHTML() final;
+  void GetDOMConstraintData(bool delta_only, GetDOMConstraintDataCallback callback) final;
+  void DiscardDOMConstraintRecording() final;
 
   // blink::mojom::LocalMainFrame overrides:
   void AnimateDoubleTapZoom(const gfx::Point& point,
@@ -839,6 +852,12 @@ class CORE_EXPORT LocalFrame final
       mojo::PendingReceiver<mojom::blink::TextFragmentSelectorProducer>
           receiver);
   static void CalculateStyle(Node *node);
+  // Returns a new styled constraint document, or nullptr if the region cannot
+  // be mapped or holds malformed data.
+  static Document* LoadDOMConstraintData(const base::ReadOnlySharedMemoryRegion& dom_constraint_data);
+  // The constraint with everything recorded so far, folded into a new
+  // document if record mode wrote to an overlay.
+  Document* CurrentDOMConstraint() const;
 
   std::unique_ptr<FrameScheduler> frame_scheduler_;
 
@@ -865,7 +884,9 @@ class CORE_EXPORT LocalFrame final
   Member<Element> page_popup_owner_;
 
   Member<Document> dom_constraint_;
-  String dom_constraint_mode_;
+  Member<DOMConstraintIndex> dom_constraint_index_;
+  Member<const DOMConstraintConfig> dom_constraint_config_;
+  const DOMGuardProbes* dom_guard_probes_;
 
   const Member<Editor> editor_;
   const Member<FrameSelection> selection_;
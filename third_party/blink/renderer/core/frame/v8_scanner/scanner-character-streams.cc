@@ -212,4 +212,68 @@ std::unique_ptr<Utf16CharacterStream> ScannerStream::ForTesting(
   return std::unique_ptr<Utf16CharacterStream>(
       new UnbufferedCharacterStream<TestingStream>(0, data, length));
 }
+
+InPlaceCharacterStream::InPlaceCharacterStream()
+    : Utf16CharacterStream(buffer_, buffer_, buffer_, 0) {}
+
+void InPlaceCharacterStream::Reset(const uint8_t* data, size_t length) {
+  data8_ = data;
+  data16_ = nullptr;
+  length_ = length;
+  ResetBuffer();
+}
+
+void InPlaceCharacterStream::Reset(const uint16_t* data, size_t length) {
+  data8_ = nullptr;
+  data16_ = data;
+  length_ = length;
+  ResetBuffer();
+}
+
+void InPlaceCharacterStream::ResetBuffer() {
+  // An empty buffer at position 0 makes the first Peek() call ReadBlock().
+  buffer_start_ = buffer_;
+  buffer_cursor_ = buffer_;
+  buffer_end_ = buffer_;
+  buffer_pos_ = 0;
+  reset_parser_error_flag();
+}
+
+std::unique_ptr<Utf16CharacterStream> InPlaceCharacterStream::Clone() const {
+  // can_be_cloned() is false.
+  return nullptr;
+}
+
+bool InPlaceCharacterStream::ReadBlock() {
+  buffer_pos_ = pos();
+  size_t position = std::min(buffer_pos_, length_);
+
+  if (data16_) {
+    buffer_start_ = data16_ + position;
+    buffer_cursor_ = buffer_start_;
+    buffer_end_ = data16_ + length_;
+    return buffer_cursor_ < buffer_end_;
+  }
+
+  size_t length = std::min(kBufferSize, length_ - position);
+  for (size_t i = 0; i < length; ++i) {
+    buffer_[i] = data8_[position + i];
+  }
+  buffer_start_ = buffer_;
+  buffer_cursor_ = buffer_;
+  buffer_end_ = buffer_ + length;
+  return length > 0;
+}
+
+Scanner& ReusableScanner::Reset(const uint8_t* data, size_t length) {
+  stream_.Reset(data, length);
+  scanner_.Reinitialize();
+  return scanner_;
+}
+
+Scanner& ReusableScanner::Reset(const uint16_t* data, size_t length) {
+  stream_.Reset(data, length);
+  scanner_.Reinitialize();
+  return scanner_;
+}
 }
@@ -7,6 +7,8 @@
 
 #include <memory>
 
+#include "third_party/blink/renderer/core/frame/v8_scanner/scanner.h"
+
 namespace v8_scanner {
 template <typename T>
 class Handle;
@@ -22,5 +24,51 @@ class ScannerStream {
   static std::unique_ptr<Utf16CharacterStream> ForTesting(const uint16_t* data,
                                                         size_t length);
 };
+
+// A character stream over caller-owned Latin-1 or UTF-16 characters that can
+// be pointed at new input without being reallocated. UTF-16 input is read in
+// place; Latin-1 input is widened one block at a time into a fixed buffer.
+// The characters must outlive every use of the stream until the next Reset().
+class InPlaceCharacterStream final : public Utf16CharacterStream {
+ public:
+  InPlaceCharacterStream();
+
+  void Reset(const uint8_t* data, size_t length);
+  void Reset(const uint16_t* data, size_t length);
+
+  bool can_be_cloned() const final { return false; }
+  std::unique_ptr<Utf16CharacterStream> Clone() const final;
+  bool can_access_heap() const final { return false; }
+
+ protected:
+  bool ReadBlock() final;
+
+ private:
+  static const size_t kBufferSize = 512;
+
+  void ResetBuffer();
+
+  const uint8_t* data8_ = nullptr;
+  const uint16_t* data16_ = nullptr;
+  size_t length_ = 0;
+  uc16 buffer_[kBufferSize];
+};
+
+// A Scanner bound to an InPlaceCharacterStream, so that the pair can be
+// reused for any number of inputs without constructing either again.
+class ReusableScanner final {
+ public:
+  ReusableScanner() : scanner_(&stream_) {}
+  ReusableScanner(const ReusableScanner&) = delete;
+  ReusableScanner& operator=(const ReusableScanner&) = delete;
+
+  // Points the stream at |data| and primes the scanner on its first token.
+  Scanner& Reset(const uint8_t* data, size_t length);
+  Scanner& Reset(const uint16_t* data, size_t length);
+
+ private:
+  InPlaceCharacterStream stream_;
+  Scanner scanner_;
+};
 }
 #endif  // V8_PARSING_SCANNER_CHARACTER_STREAMS_H_
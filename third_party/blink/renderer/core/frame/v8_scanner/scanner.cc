@@ -66,6 +66,14 @@ void Scanner::Initialize() {
   Scan();
 }
 
+void Scanner::Reinitialize() {
+  octal_pos_ = Location::invalid();
+  octal_message_ = MessageTemplate::kNone;
+  source_url_.Start();
+  source_mapping_url_.Start();
+  Initialize();
+}
+
 // static
 bool Scanner::IsInvalid(uc32 c) {
   return c == Scanner::Invalid();
@@ -220,6 +220,10 @@ class Scanner {
   explicit Scanner(Utf16CharacterStream* source);
 
   void Initialize();
+  // Like Initialize(), but for a scanner that already scanned another input
+  // from its source stream: clears the state recorded for that input first.
+  // The stream has to be reset to the new input by the caller.
+  void Reinitialize();
 
   // Returns the next token and advances input.
   Token::Value Next();
@@ -0,0 +1,336 @@
+#include "third_party/blink/tools/dom_constraint_merge/constraint_merger.h"
+
+#include <stdint.h>
+
+#include <map>
+#include <set>
+#include <utility>
+
+#include "third_party/blink/tools/dom_constraint_merge/work_stealing_pool.h"
+
+namespace dom_constraint_merge {
+
+namespace {
+
+// Attributes that DOMGuard::attributeEquals() compares as plain globs in every
+// mode. URL and script attributes are compared by other means, and ids also by
+// prefix, so a wildcard matching one of their alternatives does not make that
+// alternative redundant.
+bool IsGlobAttribute(const std::string& name) {
+  return name == "name" || name == "target" || name == "method" || name == "type";
+}
+
+bool IsLiteral(const std::string& unescaped) {
+  return unescaped.find_first_of("*?\\") == std::string::npos;
+}
+
+std::u16string ToUTF16(const std::string& utf8) {
+  std::u16string out;
+  out.reserve(utf8.size());
+  for (size_t i = 0; i < utf8.size();) {
+    unsigned char lead = utf8[i];
+    size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xe ? 3 : (lead >> 3) == 0x1e ? 4 : 0;
+    uint32_t code_point = length == 1 ? lead : length == 2 ? lead & 0x1f : length == 3 ? lead & 0x0f : lead & 0x07;
+    for (size_t j = 1; j < length; ++j) {
+      if (i + j >= utf8.size() || (static_cast<unsigned char>(utf8[i + j]) & 0xc0) != 0x80) {
+        length = 0;
+        break;
+      }
+      code_point = (code_point << 6) | (static_cast<unsigned char>(utf8[i + j]) & 0x3f);
+    }
+    if (length == 0) {
+      out += static_cast<char16_t>(0xfffd);
+      i += 1;
+      continue;
+    }
+    if (code_point >= 0x10000) {
+      out += static_cast<char16_t>(0xd800 + ((code_point - 0x10000) >> 10));
+      out += static_cast<char16_t>(0xdc00 + ((code_point - 0x10000) & 0x3ff));
+    } else {
+      out += static_cast<char16_t>(code_point);
+    }
+    i += length;
+  }
+  return out;
+}
+
+// Collects the alternatives of one attribute across elements, first one first.
+class AlternativeSet {
+ public:
+  void Add(const std::string& value) {
+    for (Alternative& alternative : SplitAlternatives(value)) {
+      if (seen_.insert(alternative.unescaped).second) {
+        alternatives_.push_back(std::move(alternative));
+      }
+    }
+  }
+
+  // Record mode adds an empty alternative for elements that lack the attribute.
+  void AddMissing() {
+    if (seen_.insert(std::string()).second) {
+      alternatives_.push_back(Alternative());
+    }
+  }
+
+  void RemoveSubsumed() {
+    std::vector<std::string> wildcards;
+    for (const Alternative& alternative : alternatives_) {
+      if (!IsLiteral(alternative.unescaped)) {
+        wildcards.push_back(alternative.unescaped);
+      }
+    }
+    if (wildcards.empty()) {
+      return;
+    }
+    std::vector<Alternative> kept;
+    for (Alternative& alternative : alternatives_) {
+      bool subsumed = false;
+      if (IsLiteral(alternative.unescaped)) {
+        for (const std::string& wildcard : wildcards) {
+          if (WildcardMatch(wildcard, alternative.unescaped)) {
+            subsumed = true;
+            break;
+          }
+        }
+      }
+      if (!subsumed) {
+        kept.push_back(std::move(alternative));
+      }
+    }
+    alternatives_ = std::move(kept);
+  }
+
+  std::string Join() const {
+    std::string value;
+    for (size_t i = 0; i < alternatives_.size(); ++i) {
+      if (i) {
+        value += '|';
+      }
+      value += alternatives_[i].raw;
+    }
+    return value;
+  }
+
+ private:
+  std::vector<Alternative> alternatives_;
+  std::set<std::string> seen_;
+};
+
+// Elements that only lead to a change in a delta dump (see DOMConstraintOverlay::Fold()) carry nothing but their
+// dtt-id, so they take part in the tree structure but not in the attributes.
+bool IsPathElement(const ConstraintNode& node) {
+  return node.FindAttribute("dtt-path");
+}
+
+void MergeAttributes(ConstraintNode& target, const std::vector<const ConstraintNode*>& sources) {
+  std::vector<const ConstraintNode*> full_sources;
+  for (const ConstraintNode* source : sources) {
+    if (!IsPathElement(*source)) {
+      full_sources.push_back(source);
+    }
+  }
+
+  // The group key, as the first element of the group has it.
+  if (const std::string* dtt_id = sources.front()->FindAttribute("dtt-id")) {
+    target.attributes.emplace_back("dtt-id", *dtt_id);
+  }
+  for (const char* flag : {"dtt-dangling", "dtt-whitelist"}) {
+    for (const ConstraintNode* source : sources) {
+      if (const std::string* value = source->FindAttribute(flag)) {
+        target.attributes.emplace_back(flag, *value);
+        break;
+      }
+    }
+  }
+  if (full_sources.empty()) {
+    target.attributes.emplace_back("dtt-path", "");
+    return;
+  }
+
+  std::vector<std::string> names;
+  std::set<std::string> seen_names = {"dtt-id", "dtt-dangling", "dtt-whitelist", "dtt-path"};
+  for (const ConstraintNode* source : full_sources) {
+    for (const auto& attribute : source->attributes) {
+      if (seen_names.insert(attribute.first).second) {
+        names.push_back(attribute.first);
+      }
+    }
+  }
+  for (const std::string& name : names) {
+    AlternativeSet alternatives;
+    for (const ConstraintNode* source : full_sources) {
+      if (const std::string* value = source->FindAttribute(name)) {
+        alternatives.Add(*value);
+      } else {
+        alternatives.AddMissing();
+      }
+    }
+    if (IsGlobAttribute(name)) {
+      alternatives.RemoveSubsumed();
+    }
+    target.attributes.emplace_back(name, alternatives.Join());
+  }
+}
+
+// Whether enforce mode would take every element that |node| stands for to |group|: each of its dtt-id alternatives
+// is a literal that the dtt-id of |group| matches.
+bool IsAbsorbedBy(const ConstraintNode& node, const ConstraintNode& group) {
+  const std::string* dtt_id = node.FindAttribute("dtt-id");
+  const std::string* group_dtt_id = group.FindAttribute("dtt-id");
+  if (!dtt_id || !group_dtt_id) {
+    return false;
+  }
+  std::vector<Alternative> group_alternatives = SplitAlternatives(*group_dtt_id);
+  for (const Alternative& alternative : SplitAlternatives(*dtt_id)) {
+    if (!IsLiteral(alternative.unescaped)) {
+      return false;
+    }
+    bool matched = false;
+    for (const Alternative& group_alternative : group_alternatives) {
+      if (WildcardMatch(group_alternative.unescaped, alternative.unescaped)) {
+        matched = true;
+        break;
+      }
+    }
+    if (!matched) {
+      return false;
+    }
+  }
+  return true;
+}
+
+class ConstraintMerger {
+ public:
+  explicit ConstraintMerger(unsigned thread_count) : pool_(thread_count) {}
+
+  std::unique_ptr<ConstraintNode> Merge(const std::vector<const ConstraintNode*>& documents) {
+    auto merged = std::make_unique<ConstraintNode>();
+    if (!documents.empty()) {
+      pool_.Run([this, &merged, documents]() { MergeChildren(*merged, documents); });
+    }
+    return merged;
+  }
+
+ private:
+  struct Group {
+    // The first element of the group, whose tag and dtt-id the group keeps.
+    const ConstraintNode* first;
+    std::vector<const ConstraintNode*> sources;
+  };
+
+  void MergeElement(ConstraintNode& target, const std::vector<const ConstraintNode*>& sources) {
+    MergeAttributes(target, sources);
+    MergeChildren(target, sources);
+  }
+
+  void MergeChildren(ConstraintNode& target, const std::vector<const ConstraintNode*>& sources) {
+    std::vector<Group> groups;
+    std::map<std::string, size_t> group_by_key;
+    std::map<std::string, std::vector<size_t>> groups_by_tag;
+    for (const ConstraintNode* source : sources) {
+      for (const auto& child : source->children) {
+        const std::string* dtt_id = child->FindAttribute("dtt-id");
+        std::string key = child->tag + (dtt_id ? '\1' + *dtt_id : std::string(1, '\0'));
+        auto it = group_by_key.find(key);
+        if (it != group_by_key.end()) {
+          groups[it->second].sources.push_back(child.get());
+          continue;
+        }
+        std::vector<size_t>& same_tag_groups = groups_by_tag[child->tag];
+        bool absorbed = false;
+        for (size_t index : same_tag_groups) {
+          if (IsAbsorbedBy(*child, *groups[index].first)) {
+            groups[index].sources.push_back(child.get());
+            absorbed = true;
+            break;
+          }
+        }
+        if (absorbed) {
+          continue;
+        }
+        group_by_key.emplace(std::move(key), groups.size());
+        same_tag_groups.push_back(groups.size());
+        groups.push_back({child.get(), {child.get()}});
+      }
+    }
+
+    // All children exist before any of them is handed out, so the tasks never touch a vector another one writes.
+    for (const Group& group : groups) {
+      target.children.push_back(std::make_unique<ConstraintNode>());
+      target.children.back()->tag = group.first->tag;
+    }
+    for (size_t i = 0; i < groups.size(); ++i) {
+      ConstraintNode* child = target.children[i].get();
+      pool_.Spawn([this, child, sources = std::move(groups[i].sources)]() { MergeElement(*child, sources); });
+    }
+  }
+
+  WorkStealingPool pool_;
+};
+
+}  // namespace
+
+std::vector<Alternative> SplitAlternatives(const std::string& value) {
+  std::vector<Alternative> alternatives(1);
+  bool is_escaped_character = false;
+  for (char c : value) {
+    if (is_escaped_character) {
+      is_escaped_character = false;
+      alternatives.back().raw += c;
+      alternatives.back().unescaped += c;
+    } else if (c == '\\') {
+      is_escaped_character = true;
+      alternatives.back().raw += c;
+    } else if (c == '|') {
+      alternatives.emplace_back();
+    } else {
+      alternatives.back().raw += c;
+      alternatives.back().unescaped += c;
+    }
+  }
+  return alternatives;
+}
+
+bool WildcardMatch(const std::string& pattern_utf8, const std::string& value_utf8) {
+  std::u16string pattern = ToUTF16(pattern_utf8);
+  std::u16string value = ToUTF16(value_utf8);
+  size_t pattern_ptr = 0;
+  size_t value_ptr = 0;
+  size_t star_pattern_ptr = std::u16string::npos;
+  size_t star_value_ptr = 0;
+  while (value_ptr < value.size()) {
+    if (pattern_ptr < pattern.size()) {
+      if (pattern[pattern_ptr] == '*') {
+        star_pattern_ptr = pattern_ptr;
+        star_value_ptr = value_ptr;
+        pattern_ptr += 1;
+        continue;
+      }
+      if (pattern[pattern_ptr] == '\\') {
+        if (pattern_ptr + 1 < pattern.size() && pattern[pattern_ptr + 1] == value[value_ptr]) {
+          pattern_ptr += 2;
+          value_ptr += 1;
+          continue;
+        }
+      } else if (pattern[pattern_ptr] == '?' || pattern[pattern_ptr] == value[value_ptr]) {
+        pattern_ptr += 1;
+        value_ptr += 1;
+        continue;
+      }
+    }
+    if (star_pattern_ptr == std::u16string::npos) {
+      return false;
+    }
+    pattern_ptr = star_pattern_ptr + 1;
+    star_value_ptr += 1;
+    value_ptr = star_value_ptr;
+  }
+  // Like DOMGuard, a used up value only takes an empty rest or a single trailing '*'.
+  return pattern_ptr == pattern.size() || (pattern_ptr + 1 == pattern.size() && pattern[pattern_ptr] == '*');
+}
+
+std::unique_ptr<ConstraintNode> MergeConstraints(const std::vector<const ConstraintNode*>& documents, unsigned thread_count) {
+  return ConstraintMerger(thread_count).Merge(documents);
+}
+
+}  // namespace dom_constraint_merge
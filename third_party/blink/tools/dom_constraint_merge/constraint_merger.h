@@ -0,0 +1,44 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef THIRD_PARTY_BLINK_TOOLS_DOM_CONSTRAINT_MERGE_CONSTRAINT_MERGER_H_
+#define THIRD_PARTY_BLINK_TOOLS_DOM_CONSTRAINT_MERGE_CONSTRAINT_MERGER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "third_party/blink/tools/dom_constraint_merge/constraint_node.h"
+
+namespace dom_constraint_merge {
+
+// One alternative of an attribute value, as DOMConstraintPattern splits it.
+struct Alternative {
+  // As written between the unescaped '|'s, so it can be joined again as is.
+  std::string raw;
+  // With one level of escapes removed; this is the glob DOMGuard matches.
+  std::string unescaped;
+};
+
+std::vector<Alternative> SplitAlternatives(const std::string& value);
+
+// Same as the matcher behind DOMGuard::stringEquals(): '*' matches any run,
+// '?' a single UTF-16 code unit, and '\' escapes the character after it.
+bool WildcardMatch(const std::string& pattern, const std::string& value);
+
+// Merges recorded constraints into one that accepts everything each of them
+// accepts, the way record mode would have merged the recordings, and then
+// drops what enforce mode can never reach:
+//  - Siblings with the same tag and dtt-id become one element, and an element
+//    whose dtt-id is matched by an earlier sibling's becomes part of it, since
+//    DOMGuard::findShadowChild() never gets past the earlier one.
+//  - Duplicate alternatives are removed, and so are literal alternatives that
+//    a wildcard of the same attribute already matches, for the attributes that
+//    are compared as plain strings.
+// Subtrees are merged in parallel on |thread_count| threads.
+std::unique_ptr<ConstraintNode> MergeConstraints(const std::vector<const ConstraintNode*>& documents, unsigned thread_count);
+
+}  // namespace dom_constraint_merge
+
+#endif  // THIRD_PARTY_BLINK_TOOLS_DOM_CONSTRAINT_MERGE_CONSTRAINT_MERGER_H_
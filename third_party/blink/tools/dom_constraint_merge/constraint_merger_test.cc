@@ -0,0 +1,122 @@
+#include "third_party/blink/tools/dom_constraint_merge/constraint_merger.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/blink/tools/dom_constraint_merge/constraint_node.h"
+
+namespace dom_constraint_merge {
+
+namespace {
+
+std::string Merge(const std::vector<std::string>& htmls, unsigned thread_count = 2) {
+  std::vector<std::unique_ptr<ConstraintNode>> documents;
+  std::vector<const ConstraintNode*> document_ptrs;
+  for (const std::string& html : htmls) {
+    documents.push_back(ParseConstraintHTML(html));
+    document_ptrs.push_back(documents.back().get());
+  }
+  return SerializeConstraintHTML(*MergeConstraints(document_ptrs, thread_count));
+}
+
+}  // namespace
+
+TEST(ConstraintMergerTest, SplitAlternatives) {
+  std::vector<Alternative> alternatives = SplitAlternatives("a|b\\|c|");
+  ASSERT_EQ(3u, alternatives.size());
+  EXPECT_EQ("a", alternatives[0].raw);
+  EXPECT_EQ("a", alternatives[0].unescaped);
+  EXPECT_EQ("b\\|c", alternatives[1].raw);
+  EXPECT_EQ("b|c", alternatives[1].unescaped);
+  EXPECT_EQ("", alternatives[2].raw);
+  EXPECT_EQ("", alternatives[2].unescaped);
+}
+
+TEST(ConstraintMergerTest, SplitAlternativesKeepsWildcardEscapes) {
+  // Only the '|'s are split on; the escaped '*' stays a glob escape.
+  std::vector<Alternative> alternatives = SplitAlternatives("a\\\\\\*");
+  ASSERT_EQ(1u, alternatives.size());
+  EXPECT_EQ("a\\\\\\*", alternatives[0].raw);
+  EXPECT_EQ("a\\*", alternatives[0].unescaped);
+
+  alternatives = SplitAlternatives("");
+  ASSERT_EQ(1u, alternatives.size());
+  EXPECT_EQ("", alternatives[0].unescaped);
+}
+
+TEST(ConstraintMergerTest, WildcardMatch) {
+  EXPECT_TRUE(WildcardMatch("foo", "foo"));
+  EXPECT_FALSE(WildcardMatch("foo", "food"));
+  EXPECT_TRUE(WildcardMatch("foo*", "foo"));
+  EXPECT_TRUE(WildcardMatch("foo*", "foobar"));
+  EXPECT_TRUE(WildcardMatch("*bar", "foobar"));
+  EXPECT_FALSE(WildcardMatch("*bar", "foobarx"));
+  EXPECT_TRUE(WildcardMatch("a*b*c", "a-b-b-c"));
+  EXPECT_TRUE(WildcardMatch("f?o", "fxo"));
+  EXPECT_FALSE(WildcardMatch("f?o", "fo"));
+  EXPECT_TRUE(WildcardMatch("\\*", "*"));
+  EXPECT_FALSE(WildcardMatch("\\*", "x"));
+  EXPECT_TRUE(WildcardMatch("\\?", "?"));
+  EXPECT_FALSE(WildcardMatch("\\?", "x"));
+}
+
+TEST(ConstraintMergerTest, WildcardMatchCountsUTF16CodeUnits) {
+  // U+00E9 is one UTF-16 code unit, U+1F600 a surrogate pair.
+  EXPECT_TRUE(WildcardMatch("?", "\xC3\xA9"));
+  EXPECT_FALSE(WildcardMatch("?", "\xF0\x9F\x98\x80"));
+  EXPECT_TRUE(WildcardMatch("??", "\xF0\x9F\x98\x80"));
+}
+
+TEST(ConstraintMergerTest, MergesAlternativesOfTheSameElement) {
+  EXPECT_EQ("<div dtt-id=\"a\" class=\"x|y\"></div>", Merge({"<div dtt-id=\"a\" class=\"x\"></div>", "<div dtt-id=\"a\" class=\"y|x\"></div>"}));
+}
+
+TEST(ConstraintMergerTest, MissingAttributeAddsEmptyAlternative) {
+  EXPECT_EQ("<div dtt-id=\"a\" class=\"x|\"></div>", Merge({"<div dtt-id=\"a\" class=\"x\"></div>", "<div dtt-id=\"a\"></div>"}));
+}
+
+TEST(ConstraintMergerTest, RemovesSubsumedLiteralsOfGlobAttributes) {
+  EXPECT_EQ("<input dtt-id=\"a\" name=\"item-*\" type=\"text\">", Merge({"<input dtt-id=\"a\" name=\"item-1\" type=\"text\">", "<input dtt-id=\"a\" name=\"item-*|item-2\" type=\"text\">"}));
+}
+
+TEST(ConstraintMergerTest, KeepsSubsumedLiteralsOfOtherAttributes) {
+  // Only name, target, method and type are compared as plain globs.
+  EXPECT_EQ("<div dtt-id=\"a\" id=\"item-1|item-*\"></div>", Merge({"<div dtt-id=\"a\" id=\"item-1\"></div>", "<div dtt-id=\"a\" id=\"item-*\"></div>"}));
+}
+
+TEST(ConstraintMergerTest, KeepsWildcardsMatchedByOtherWildcards) {
+  EXPECT_EQ("<a dtt-id=\"a\" target=\"*|_?\"></a>", Merge({"<a dtt-id=\"a\" target=\"*\"></a>", "<a dtt-id=\"a\" target=\"_?\"></a>"}));
+}
+
+TEST(ConstraintMergerTest, AbsorbsLiteralDttIdsMatchedByEarlierSibling) {
+  EXPECT_EQ("<li dtt-id=\"row-*\" class=\"x|y\"></li>", Merge({"<li dtt-id=\"row-*\" class=\"x\"></li>", "<li dtt-id=\"row-3|row-4\" class=\"y\"></li>"}));
+}
+
+TEST(ConstraintMergerTest, DoesNotAbsorbWildcardOrUnmatchedDttIds) {
+  EXPECT_EQ("<li dtt-id=\"row-*\"></li><li dtt-id=\"row-?\"></li><li dtt-id=\"row-1|col-1\"></li><p dtt-id=\"row-2\"></p>", Merge({"<li dtt-id=\"row-*\"></li>", "<li dtt-id=\"row-?\"></li><li dtt-id=\"row-1|col-1\"></li><p dtt-id=\"row-2\"></p>"}));
+}
+
+TEST(ConstraintMergerTest, DoesNotAbsorbIntoLaterSibling) {
+  EXPECT_EQ("<li dtt-id=\"row-3\"></li><li dtt-id=\"row-*\"></li>", Merge({"<li dtt-id=\"row-3\"></li><li dtt-id=\"row-*\"></li>"}));
+}
+
+TEST(ConstraintMergerTest, PathElementsOnlyContributeStructure) {
+  EXPECT_EQ("<div dtt-id=\"a\" class=\"y\"><span dtt-id=\"b\" class=\"z\"></span></div>", Merge({"<div dtt-id=\"a\" dtt-path=\"\"><span dtt-id=\"b\" class=\"z\"></span></div>", "<div dtt-id=\"a\" class=\"y\"></div>"}));
+}
+
+TEST(ConstraintMergerTest, MergedPathElementsStayPathElements) {
+  EXPECT_EQ("<div dtt-id=\"a\" dtt-path=\"\"><span dtt-id=\"b\" class=\"y|z\"></span></div>", Merge({"<div dtt-id=\"a\" dtt-path=\"\"><span dtt-id=\"b\" class=\"y\"></span></div>", "<div dtt-id=\"a\" dtt-path=\"\"><span dtt-id=\"b\" class=\"z\"></span></div>"}));
+}
+
+TEST(ConstraintMergerTest, ResultDoesNotDependOnThreadCount) {
+  std::vector<std::string> htmls = {"<ul dtt-id=\"l\"><li dtt-id=\"row-*\"><b dtt-id=\"x\" class=\"1\"></b></li><li dtt-id=\"other\"></li></ul>", "<ul dtt-id=\"l\" class=\"c\"><li dtt-id=\"row-7\"><b dtt-id=\"x\" class=\"2\"></b><i dtt-id=\"y\"></i></li></ul>"};
+  std::string expected = Merge(htmls, 1);
+  EXPECT_EQ("<ul dtt-id=\"l\" class=\"|c\"><li dtt-id=\"row-*\"><b dtt-id=\"x\" class=\"1|2\"></b><i dtt-id=\"y\"></i></li><li dtt-id=\"other\"></li></ul>", expected);
+  for (unsigned thread_count : {2u, 4u, 8u}) {
+    EXPECT_EQ(expected, Merge(htmls, thread_count));
+  }
+}
+
+}  // namespace dom_constraint_merge
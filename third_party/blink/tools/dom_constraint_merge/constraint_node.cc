@@ -0,0 +1,377 @@
+#include "third_party/blink/tools/dom_constraint_merge/constraint_node.h"
+
+#include <ctype.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+
+namespace dom_constraint_merge {
+
+namespace {
+
+const char kBeginMarker[] = "BeginOutputDOMConstraintHTML";
+const char kEndMarker[] = "EndOutputDOMConstraintHTML";
+
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+bool IsNameCharacter(char c) {
+  return !IsSpace(c) && c != '>' && c != '/' && c != '=' && c != '"' && c != '\'' && c != '<';
+}
+
+std::string ToLower(std::string s) {
+  std::transform(s.begin(), s.end(), s.begin(), [](char c) { return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c; });
+  return s;
+}
+
+std::string ToUpper(std::string s) {
+  std::transform(s.begin(), s.end(), s.begin(), [](char c) { return c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c; });
+  return s;
+}
+
+bool IsVoidElement(const std::string& tag) {
+  static const char* const kVoidElements[] = {"AREA", "BASE", "BASEFONT", "BGSOUND", "BR", "COL", "EMBED", "FRAME", "HR", "IMG", "INPUT", "KEYGEN", "LINK", "META", "PARAM", "SOURCE", "TRACK", "WBR"};
+  for (const char* void_element : kVoidElements) {
+    if (tag == void_element) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Elements whose content the HTML parser reads as text up to the end tag.
+bool IsRawTextElement(const std::string& tag) {
+  static const char* const kRawTextElements[] = {"IFRAME", "NOEMBED", "NOFRAMES", "PLAINTEXT", "SCRIPT", "STYLE", "TEXTAREA", "TITLE", "XMP"};
+  for (const char* raw_text_element : kRawTextElements) {
+    if (tag == raw_text_element) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AppendUTF8(std::string& out, uint32_t code_point) {
+  if (code_point < 0x80) {
+    out += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    out += static_cast<char>(0xc0 | (code_point >> 6));
+    out += static_cast<char>(0x80 | (code_point & 0x3f));
+  } else if (code_point < 0x10000) {
+    out += static_cast<char>(0xe0 | (code_point >> 12));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (code_point & 0x3f));
+  } else {
+    out += static_cast<char>(0xf0 | (code_point >> 18));
+    out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3f));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (code_point & 0x3f));
+  }
+}
+
+// Decodes the character references the markup serializer produces, plus
+// numeric ones. Anything else is kept as written.
+std::string DecodeCharacterReferences(const std::string& value) {
+  static const struct {
+    const char* name;
+    uint32_t code_point;
+  } kNamedReferences[] = {{"amp;", '&'}, {"quot;", '"'}, {"apos;", '\''}, {"lt;", '<'}, {"gt;", '>'}, {"nbsp;", 0xa0}};
+
+  std::string out;
+  out.reserve(value.size());
+  for (size_t i = 0; i < value.size(); ++i) {
+    if (value[i] != '&') {
+      out += value[i];
+      continue;
+    }
+    bool decoded = false;
+    if (i + 1 < value.size() && value[i + 1] == '#') {
+      bool hex = i + 2 < value.size() && (value[i + 2] == 'x' || value[i + 2] == 'X');
+      size_t digits_begin = i + (hex ? 3 : 2);
+      size_t end = digits_begin;
+      uint32_t code_point = 0;
+      while (end < value.size() && end - digits_begin < 8 && (hex ? isxdigit(static_cast<unsigned char>(value[end])) : isdigit(static_cast<unsigned char>(value[end])))) {
+        char c = value[end];
+        code_point = code_point * (hex ? 16 : 10) + (isdigit(static_cast<unsigned char>(c)) ? c - '0' : (c | 0x20) - 'a' + 10);
+        end += 1;
+      }
+      if (end > digits_begin && end < value.size() && value[end] == ';' && code_point <= 0x10ffff) {
+        AppendUTF8(out, code_point);
+        i = end;
+        decoded = true;
+      }
+    } else {
+      for (const auto& reference : kNamedReferences) {
+        if (value.compare(i + 1, strlen(reference.name), reference.name) == 0) {
+          AppendUTF8(out, reference.code_point);
+          i += strlen(reference.name);
+          decoded = true;
+          break;
+        }
+      }
+    }
+    if (!decoded) {
+      out += '&';
+    }
+  }
+  return out;
+}
+
+void AppendEscapedAttributeValue(std::string& out, const std::string& value) {
+  for (size_t i = 0; i < value.size(); ++i) {
+    char c = value[i];
+    if (c == '&') {
+      out += "&amp;";
+    } else if (c == '"') {
+      out += "&quot;";
+    } else if (c == '<') {
+      out += "&lt;";
+    } else if (c == '>') {
+      out += "&gt;";
+    } else if (c == '\xc2' && i + 1 < value.size() && value[i + 1] == '\xa0') {
+      out += "&nbsp;";
+      i += 1;
+    } else {
+      out += c;
+    }
+  }
+}
+
+class Parser {
+ public:
+  explicit Parser(const std::string& html) : html_(html) {}
+
+  std::unique_ptr<ConstraintNode> Parse() {
+    auto document = std::make_unique<ConstraintNode>();
+    open_elements_.push_back(document.get());
+    while (position_ < html_.size()) {
+      size_t tag_begin = html_.find('<', position_);
+      if (tag_begin == std::string::npos) {
+        break;
+      }
+      position_ = tag_begin + 1;
+      if (html_.compare(position_, 3, "!--") == 0) {
+        size_t comment_end = html_.find("-->", position_ + 3);
+        position_ = comment_end == std::string::npos ? html_.size() : comment_end + 3;
+      } else if (position_ < html_.size() && (html_[position_] == '!' || html_[position_] == '?')) {
+        SkipPast('>');
+      } else if (position_ < html_.size() && html_[position_] == '/') {
+        position_ += 1;
+        ParseEndTag();
+      } else if (position_ < html_.size() && isalpha(static_cast<unsigned char>(html_[position_]))) {
+        ParseStartTag();
+      }
+    }
+    return document;
+  }
+
+ private:
+  void SkipPast(char c) {
+    size_t end = html_.find(c, position_);
+    position_ = end == std::string::npos ? html_.size() : end + 1;
+  }
+
+  void SkipSpaces() {
+    while (position_ < html_.size() && IsSpace(html_[position_])) {
+      position_ += 1;
+    }
+  }
+
+  std::string ReadName() {
+    size_t begin = position_;
+    while (position_ < html_.size() && IsNameCharacter(html_[position_])) {
+      position_ += 1;
+    }
+    return html_.substr(begin, position_ - begin);
+  }
+
+  std::string ReadAttributeValue() {
+    if (position_ < html_.size() && (html_[position_] == '"' || html_[position_] == '\'')) {
+      char quote = html_[position_++];
+      size_t end = html_.find(quote, position_);
+      if (end == std::string::npos) {
+        end = html_.size();
+      }
+      std::string value = html_.substr(position_, end - position_);
+      position_ = std::min(end + 1, html_.size());
+      return DecodeCharacterReferences(value);
+    }
+    size_t begin = position_;
+    while (position_ < html_.size() && !IsSpace(html_[position_]) && html_[position_] != '>') {
+      position_ += 1;
+    }
+    return DecodeCharacterReferences(html_.substr(begin, position_ - begin));
+  }
+
+  void ParseStartTag() {
+    auto element = std::make_unique<ConstraintNode>();
+    element->tag = ToUpper(ReadName());
+    while (true) {
+      SkipSpaces();
+      if (position_ >= html_.size()) {
+        break;
+      }
+      if (html_[position_] == '>') {
+        position_ += 1;
+        break;
+      }
+      if (html_[position_] == '/') {
+        position_ += 1;
+        continue;
+      }
+      std::string name = ToLower(ReadName());
+      if (name.empty()) {
+        // A stray '=' or quote; drop it like the tokenizer would.
+        position_ += 1;
+        continue;
+      }
+      SkipSpaces();
+      std::string value;
+      if (position_ < html_.size() && html_[position_] == '=') {
+        position_ += 1;
+        SkipSpaces();
+        value = ReadAttributeValue();
+      }
+      // The first of several attributes with the same name wins.
+      if (!element->FindAttribute(name)) {
+        element->attributes.emplace_back(std::move(name), std::move(value));
+      }
+    }
+
+    ConstraintNode* element_ptr = element.get();
+    open_elements_.back()->children.push_back(std::move(element));
+    if (IsVoidElement(element_ptr->tag)) {
+      return;
+    }
+    if (IsRawTextElement(element_ptr->tag)) {
+      SkipRawText(element_ptr->tag);
+      return;
+    }
+    open_elements_.push_back(element_ptr);
+  }
+
+  void ParseEndTag() {
+    std::string tag = ToUpper(ReadName());
+    SkipPast('>');
+    // Unmatched end tags are ignored; matched ones also close whatever was left open inside.
+    for (size_t i = open_elements_.size(); i-- > 1;) {
+      if (open_elements_[i]->tag == tag) {
+        open_elements_.resize(i);
+        return;
+      }
+    }
+  }
+
+  void SkipRawText(const std::string& tag) {
+    std::string end_tag = "</" + ToLower(tag);
+    while (position_ < html_.size()) {
+      size_t end = html_.find("</", position_);
+      if (end == std::string::npos) {
+        position_ = html_.size();
+        return;
+      }
+      position_ = end + 2;
+      if (ToLower(html_.substr(end, end_tag.size())) == end_tag) {
+        SkipPast('>');
+        return;
+      }
+    }
+  }
+
+  const std::string& html_;
+  size_t position_ = 0;
+  std::vector<ConstraintNode*> open_elements_;
+};
+
+void SerializeChildren(const ConstraintNode& node, std::string& out) {
+  for (const auto& child : node.children) {
+    std::string tag = ToLower(child->tag);
+    out += '<';
+    out += tag;
+    for (const auto& attribute : child->attributes) {
+      out += ' ';
+      out += attribute.first;
+      out += "=\"";
+      AppendEscapedAttributeValue(out, attribute.second);
+      out += '"';
+    }
+    out += '>';
+    if (IsVoidElement(child->tag)) {
+      continue;
+    }
+    SerializeChildren(*child, out);
+    out += "</";
+    out += tag;
+    out += '>';
+  }
+}
+
+}  // namespace
+
+const std::string* ConstraintNode::FindAttribute(const std::string& name) const {
+  for (const auto& attribute : attributes) {
+    if (attribute.first == name) {
+      return &attribute.second;
+    }
+  }
+  return nullptr;
+}
+
+std::string ExtractConstraintHTML(const std::string& text) {
+  size_t begin = text.rfind(kBeginMarker);
+  if (begin == std::string::npos) {
+    return text;
+  }
+  size_t end = text.find(kEndMarker, begin);
+  if (end == std::string::npos) {
+    end = text.size();
+  } else {
+    // Back up to the start of the line carrying the end marker.
+    size_t line_begin = text.rfind('\n', end);
+    end = line_begin == std::string::npos || line_begin < begin ? end : line_begin;
+  }
+
+  // Every chunk is a log message of its own: "[<prefix>] <chunk>\n".
+  std::string html;
+  size_t position = text.find('\n', begin);
+  while (position != std::string::npos && position < end) {
+    position += 1;
+    size_t message_begin = position;
+    if (message_begin < end && text[message_begin] == '[') {
+      size_t prefix_end = text.find("] ", message_begin);
+      if (prefix_end != std::string::npos && prefix_end < end) {
+        message_begin = prefix_end + 2;
+      }
+    }
+    // A chunk may itself contain newlines, so it runs up to the next line that starts a log message.
+    size_t message_end = message_begin;
+    while (true) {
+      size_t newline = text.find('\n', message_end);
+      if (newline == std::string::npos || newline >= end) {
+        message_end = end;
+        break;
+      }
+      if (newline + 1 < text.size() && text[newline + 1] == '[') {
+        message_end = newline;
+        break;
+      }
+      message_end = newline + 1;
+    }
+    html.append(text, message_begin, message_end - message_begin);
+    position = message_end < end ? message_end : std::string::npos;
+  }
+  return html;
+}
+
+std::unique_ptr<ConstraintNode> ParseConstraintHTML(const std::string& html) {
+  return Parser(html).Parse();
+}
+
+std::string SerializeConstraintHTML(const ConstraintNode& document) {
+  std::string out;
+  SerializeChildren(document, out);
+  return out;
+}
+
+}  // namespace dom_constraint_merge
@@ -0,0 +1,46 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef THIRD_PARTY_BLINK_TOOLS_DOM_CONSTRAINT_MERGE_CONSTRAINT_NODE_H_
+#define THIRD_PARTY_BLINK_TOOLS_DOM_CONSTRAINT_MERGE_CONSTRAINT_NODE_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dom_constraint_merge {
+
+// One element of a DOM constraint outside the browser, or the document itself
+// (with an empty tag). Only elements and their attributes are kept; text and
+// comments never take part in matching. Everything is UTF-8.
+struct ConstraintNode {
+  // Upper case, like Element::tagName() of the shadow elements.
+  std::string tag;
+  // In document order, with lower case names as the HTML parser leaves them.
+  std::vector<std::pair<std::string, std::string>> attributes;
+  std::vector<std::unique_ptr<ConstraintNode>> children;
+
+  // Returns nullptr if the attribute is absent.
+  const std::string* FindAttribute(const std::string& name) const;
+};
+
+// Returns the markup of a constraint dump. |text| is either the markup itself
+// or a log holding the output of LocalFrame::OutputDOMConstraintHTML(), whose
+// chunks between "BeginOutputDOMConstraintHTML" and
+// "EndOutputDOMConstraintHTML" are stripped of their log prefixes and joined.
+// If the log holds several dumps, the last one is used.
+std::string ExtractConstraintHTML(const std::string& text);
+
+// Parses constraint markup into a tree. This is not the HTML tree builder: the
+// element structure is taken as written, except that void elements never get
+// children, so that serializing the tree again and loading it through
+// SetDOMConstraintHTML() rebuilds what loading the original markup would have.
+std::unique_ptr<ConstraintNode> ParseConstraintHTML(const std::string& html);
+
+std::string SerializeConstraintHTML(const ConstraintNode& document);
+
+}  // namespace dom_constraint_merge
+
+#endif  // THIRD_PARTY_BLINK_TOOLS_DOM_CONSTRAINT_MERGE_CONSTRAINT_NODE_H_
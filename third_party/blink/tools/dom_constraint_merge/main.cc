@@ -0,0 +1,89 @@
+// Merges recorded DOM constraints into one minimized constraint.
+//
+// Usage: dom_constraint_merge [--threads=N] [--output=FILE] INPUT...
+//
+// Every input is either constraint markup or a log holding the output of
+// LocalFrame::OutputDOMConstraintHTML(). The result is written to FILE, or to
+// stdout, as markup that SetDOMConstraintHTML() takes.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "third_party/blink/tools/dom_constraint_merge/constraint_merger.h"
+#include "third_party/blink/tools/dom_constraint_merge/constraint_node.h"
+
+namespace {
+
+const char kThreadsSwitch[] = "--threads=";
+const char kOutputSwitch[] = "--output=";
+
+bool StartsWith(const std::string& s, const char* prefix) {
+  return s.compare(0, strlen(prefix), prefix) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  unsigned thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+  std::string output_path;
+  std::vector<std::string> input_paths;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (StartsWith(arg, kThreadsSwitch)) {
+      int value = atoi(arg.c_str() + strlen(kThreadsSwitch));
+      if (value < 1) {
+        fprintf(stderr, "Invalid thread count: %s\n", arg.c_str());
+        return 1;
+      }
+      thread_count = value;
+    } else if (StartsWith(arg, kOutputSwitch)) {
+      output_path = arg.substr(strlen(kOutputSwitch));
+    } else {
+      input_paths.push_back(arg);
+    }
+  }
+  if (input_paths.empty()) {
+    fprintf(stderr, "Usage: %s [--threads=N] [--output=FILE] INPUT...\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<dom_constraint_merge::ConstraintNode>> documents;
+  for (const std::string& input_path : input_paths) {
+    std::ifstream input(input_path, std::ios::binary);
+    if (!input) {
+      fprintf(stderr, "Cannot read %s\n", input_path.c_str());
+      return 1;
+    }
+    std::stringstream text;
+    text << input.rdbuf();
+    documents.push_back(dom_constraint_merge::ParseConstraintHTML(dom_constraint_merge::ExtractConstraintHTML(text.str())));
+  }
+
+  std::vector<const dom_constraint_merge::ConstraintNode*> document_ptrs;
+  for (const auto& document : documents) {
+    document_ptrs.push_back(document.get());
+  }
+  std::string html = dom_constraint_merge::SerializeConstraintHTML(*dom_constraint_merge::MergeConstraints(document_ptrs, thread_count));
+
+  if (output_path.empty()) {
+    std::cout << html << std::endl;
+    return 0;
+  }
+  std::ofstream output(output_path, std::ios::binary);
+  output << html;
+  if (!output) {
+    fprintf(stderr, "Cannot write %s\n", output_path.c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,97 @@
+#include "third_party/blink/tools/dom_constraint_merge/work_stealing_pool.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+namespace dom_constraint_merge {
+
+namespace {
+
+// The worker the current thread runs as, if it belongs to a pool.
+thread_local unsigned g_worker_index = 0;
+
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned thread_count) {
+  for (unsigned i = 0; i < std::max(thread_count, 1u); ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+}
+
+void WorkStealingPool::Run(Task task) {
+  pending_tasks_ = 1;
+  queued_tasks_ = 1;
+  workers_[0]->tasks.push_back(std::move(task));
+
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < workers_.size(); ++i) {
+    threads.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+  }
+  WorkerLoop(0);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+void WorkStealingPool::Spawn(Task task) {
+  pending_tasks_ += 1;
+  {
+    Worker& worker = *workers_[g_worker_index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.tasks.push_back(std::move(task));
+    queued_tasks_ += 1;
+  }
+  std::lock_guard<std::mutex> lock(idle_mutex_);
+  work_available_.notify_one();
+}
+
+void WorkStealingPool::WorkerLoop(unsigned index) {
+  g_worker_index = index;
+  Task task;
+  while (true) {
+    if (PopOrSteal(index, task)) {
+      task();
+      task = nullptr;
+      // Only drops to zero once every spawned task has run, since a task is counted before it is queued.
+      if (pending_tasks_.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        work_available_.notify_all();
+        return;
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    // A task queued between the failed steal and here is seen by the predicate, so the thread does not sleep through it.
+    work_available_.wait(lock, [this] { return pending_tasks_ == 0 || queued_tasks_ != 0; });
+    if (pending_tasks_ == 0) {
+      return;
+    }
+  }
+}
+
+bool WorkStealingPool::PopOrSteal(unsigned index, Task& task) {
+  {
+    Worker& own = *workers_[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      queued_tasks_ -= 1;
+      return true;
+    }
+  }
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    Worker& victim = *workers_[(index + i) % workers_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      queued_tasks_ -= 1;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace dom_constraint_merge
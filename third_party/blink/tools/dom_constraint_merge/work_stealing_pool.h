@@ -0,0 +1,63 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef THIRD_PARTY_BLINK_TOOLS_DOM_CONSTRAINT_MERGE_WORK_STEALING_POOL_H_
+#define THIRD_PARTY_BLINK_TOOLS_DOM_CONSTRAINT_MERGE_WORK_STEALING_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dom_constraint_merge {
+
+// Runs a task, and every task it spawns, on a fixed number of threads. Each
+// thread keeps its own deque: it pushes and pops spawned tasks at the back, so
+// it works depth first through the subtree it is in, while idle threads steal
+// from the front of the others, where the largest pieces of work wait. A
+// thread that finds nothing to steal sleeps until a task is spawned or the run
+// is over.
+class WorkStealingPool {
+ public:
+  using Task = std::function<void()>;
+
+  // |thread_count| is at least 1; the calling thread is one of them.
+  explicit WorkStealingPool(unsigned thread_count);
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  // Runs |task| and everything spawned from it, and returns once all of it is
+  // done.
+  void Run(Task task);
+  // Only valid from within a task of this pool.
+  void Spawn(Task task);
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void WorkerLoop(unsigned index);
+  bool PopOrSteal(unsigned index, Task& task);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // Tasks spawned but not finished yet.
+  std::atomic<size_t> pending_tasks_{0};
+  // Tasks waiting in any of the deques; only changed under the mutex of the
+  // deque.
+  std::atomic<size_t> queued_tasks_{0};
+  // Idle threads wait on |work_available_| under |idle_mutex_|, which Spawn()
+  // and the last task to finish take before they notify, so that no wakeup is
+  // lost.
+  std::mutex idle_mutex_;
+  std::condition_variable work_available_;
+};
+
+}  // namespace dom_constraint_merge
+
+#endif  // THIRD_PARTY_BLINK_TOOLS_DOM_CONSTRAINT_MERGE_WORK_STEALING_POOL_H_